@@ -0,0 +1,77 @@
+// Lista de todos los assets del juego; la única lista. Sin include guard a
+// propósito: Assets.h la incluye varias veces para armar los enum y las
+// tablas, interfaz.pro comprueba al correr qmake que cada archivo exista (si
+// falta uno no se compila) y tools/assetcook cocina las líneas SPRITE.
+// Una entrada por línea, con estos mismos espacios:
+//
+//   SPRITE(id, "archivo", ancho, alto, Modo, espejado)   variante para SpriteCache
+//   IMAGE(id, "archivo")                                 el archivo tal cual (HTML, hojas de estilo)
+//   MUSIC(id, "archivo")                                 pista para MusicStream
+//
+// Archivos relativos a la raíz; los de SPRITE e IMAGE van en el .qrc con el
+// prefijo /images y los de MUSIC con /sound. Tamaño 0, 0 = el original;
+// Modo: Ignore | Keep (el Qt::AspectRatioMode). Los efectos de sonido no
+// están acá: van en el banco (SoundId, AudioMixer.h).
+
+// --- HUD ---
+SPRITE(Life1,               "images/vida1.png",               200,  90, Keep,   false)
+SPRITE(Life2,               "images/vida2.png",               200,  90, Keep,   false)
+SPRITE(Life3,               "images/vida3.png",               200,  90, Keep,   false)
+SPRITE(Life4,               "images/vida4.png",               200,  90, Keep,   false)
+SPRITE(Life5,               "images/vida5.png",               200,  90, Keep,   false)
+SPRITE(Life6,               "images/vida6.png",               200,  90, Keep,   false)
+IMAGE(Cover,                "images/Caratula.jpg")
+IMAGE(IconRifle,            "images/rifle.png")
+IMAGE(IconGrenade,          "images/granade.png")
+IMAGE(IconFlamethrower,     "images/lanzallamas.png")
+
+// --- nivel 1: jugador (PlayerItem::loadFrames) ---
+SPRITE(PlayerIdle,          "images/Soldado.png",               0,   0, Ignore, false)
+SPRITE(PlayerIdleFlip,      "images/Soldado.png",               0,   0, Ignore, true)
+SPRITE(PlayerRun1,          "images/Soldado1.png",              0,   0, Ignore, false)
+SPRITE(PlayerRun1Flip,      "images/Soldado1.png",              0,   0, Ignore, true)
+SPRITE(PlayerRun2,          "images/Soldado4.png",              0,   0, Ignore, false)
+SPRITE(PlayerRun2Flip,      "images/Soldado4.png",              0,   0, Ignore, true)
+SPRITE(PlayerRun3,          "images/Soldado2.png",              0,   0, Ignore, false)
+SPRITE(PlayerRun3Flip,      "images/Soldado2.png",              0,   0, Ignore, true)
+SPRITE(PlayerCrouch,        "images/Soldado_abajo.png",         0,   0, Ignore, false)
+SPRITE(PlayerCrouchFlip,    "images/Soldado_abajo.png",         0,   0, Ignore, true)
+SPRITE(PlayerJump,          "images/Soldado_arriba.png",        0,   0, Ignore, false)
+SPRITE(PlayerJumpFlip,      "images/Soldado_arriba.png",        0,   0, Ignore, true)
+SPRITE(PlayerDead,          "images/Soldado_muerto.png",      100, 106, Ignore, false)
+
+// --- nivel 1: enemigos (EnemyItem), búnker y fondo ---
+SPRITE(EnemyWalk1,          "images/enemigo1.png",             81, 106, Ignore, false)
+SPRITE(EnemyWalk2,          "images/enemigo2.png",             81, 106, Ignore, false)
+SPRITE(EnemyWalk3,          "images/enemigo3.png",             81, 106, Ignore, false)
+SPRITE(EnemyWalk4,          "images/enemigo4.png",             81, 106, Ignore, false)
+SPRITE(EnemyDeath1,         "images/muerte_enemigo1.png",      81, 106, Ignore, false)
+SPRITE(EnemyDeath2,         "images/muerte_enemigo2.png",      81, 106, Ignore, false)
+SPRITE(EnemyDeath3,         "images/muerte_enemigo3.png",      81, 106, Ignore, false)
+SPRITE(EnemyBlast1,         "images/explosion_enemigo1.png",   81, 106, Ignore, false)
+SPRITE(EnemyBlast2,         "images/explosion_enemigo2.png",   81, 106, Ignore, false)
+SPRITE(EnemyBlast3,         "images/explosion_enemigo3.png",   81, 106, Ignore, false)
+SPRITE(EnemyCrouch,         "images/enemigo_agachado.png",      0,   0, Ignore, false)
+SPRITE(BunkerIdle,          "images/bunker_quieto.png",         0,   0, Ignore, false)
+SPRITE(BunkerShoot,         "images/bunker_disparando.png",     0,   0, Ignore, false)
+SPRITE(BunkerDestroyed,     "images/bunker_destruido.png",      0,   0, Ignore, false)
+SPRITE(BackgroundBeach,     "images/fondo_playa.png",        2800, 600, Ignore, false)
+
+// --- proyectiles ---
+SPRITE(Bullet,              "images/Bala.png",                 24,  12, Keep,   false)
+SPRITE(Grenade,             "images/granade.png",              24,  24, Keep,   false)
+SPRITE(GrenadeBlast,        "images/granada_explosion.png",   160, 160, Keep,   false)
+
+// --- nivel 2 ---
+SPRITE(BackgroundLevel2,    "images/fondo_2.png",            1280, 650, Ignore, false)
+SPRITE(TopDownPlayer,       "images/jugador_vivo.png",         70,  70, Keep,   false)
+SPRITE(TopDownPlayerDead,   "images/jugador_muerto.png",      200, 200, Keep,   false)
+SPRITE(TopDownEnemyWalk,    "images/enemigo_camina.png",       60,  60, Keep,   false)
+SPRITE(TopDownEnemyShoot,   "images/enemigo_dispara.png",      90,  90, Keep,   false)
+SPRITE(TopDownEnemyDead,    "images/enemigo_muerto_2.png",     90,  90, Keep,   false)
+SPRITE(Flame,               "images/flame.png",               180,  80, Ignore, false)
+
+// --- música ---
+MUSIC(Menu,                 "sounds/tema_menu .wav")
+MUSIC(Beach,                "sounds/ambiente_playa.wav")
+MUSIC(Defeat,               "sounds/derrota.wav")
@@ -0,0 +1,151 @@
+#include "AssetPreloader.h"
+#include "Assets.h"
+#include "SpriteAtlas.h"
+#include "SpriteCache.h"
+#include <QElapsedTimer>
+#include <QImageReader>
+#include <QPixmap>
+#include <QRunnable>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+
+// Tiempo máximo de GUI por tanda de conversión a QPixmap
+static const int kBatchBudgetMs = 4;
+
+AssetPreloader::AssetPreloader(QObject *parent)
+    : QObject(parent)
+{
+    // dejar un núcleo libre para la GUI y el audio
+    pool_.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+
+    batchTimer_ = new QTimer(this);
+    batchTimer_->setSingleShot(true);
+    batchTimer_->setInterval(0);
+    connect(batchTimer_, &QTimer::timeout, this, &AssetPreloader::convertBatch);
+}
+
+AssetPreloader::~AssetPreloader()
+{
+    // lo que no empezó se descarta; lo que está decodificando se espera
+    pool_.clear();
+    pool_.waitForDone();
+}
+
+void AssetPreloader::start()
+{
+    if (started_) return;
+    started_ = true;
+
+    // una tarea por archivo (o por página del atlas): se decodifica una vez
+    // para todas sus variantes
+    // todas las variantes SPRITE de AssetList.h, con la misma clave con la
+    // que las pide el juego (las IMAGE no pasan por SpriteCache)
+    const SpriteAtlas &atlas = SpriteAtlas::instance();
+    QVector<Job> jobs;
+    for (const SpriteDef &def : kSpriteDefs) {
+        if (!def.sprite) continue;
+        const QString path = QString::fromLatin1(def.path);
+        if (SpriteCache::contains(path, def.size(), def.mode, def.flipX)) continue;
+
+        Variant v{ path, def.size(), def.mode, def.flipX, QRect() };
+        QString file = path;
+        const int cooked = atlas.find(path, def.size(), def.mode, def.flipX);
+        if (cooked >= 0) {
+            const SpriteAtlas::Entry &e = atlas.entries().at(cooked);
+            file = atlas.pagePath(e.page);
+            v.atlasRect = e.rect;
+        }
+
+        auto it = std::find_if(jobs.begin(), jobs.end(), [&file](const Job &j) { return j.file == file; });
+        if (it == jobs.end()) it = jobs.insert(jobs.end(), Job{ file, cooked >= 0, {} });
+        it->variants.append(v);
+        ++total_;
+    }
+
+    if (jobs.isEmpty()) {
+        finishIfDone();
+        return;
+    }
+
+    for (const Job &job : jobs) {
+        pool_.start(QRunnable::create([this, job] {
+            const QVector<Result> results = decode(job);
+            QMetaObject::invokeMethod(this, [this, results] { deliver(results); }, Qt::QueuedConnection);
+        }));
+    }
+}
+
+QVector<AssetPreloader::Result> AssetPreloader::decode(const Job &job)
+{
+    QVector<Result> results;
+    results.reserve(job.variants.size());
+
+    // página cocinada: ya está escalada y espejada, sólo se recorta
+    if (job.atlas) {
+        QImage page = QImageReader(job.file).read();
+        if (!page.isNull()) page = page.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        for (const Variant &v : job.variants)
+            results.append(Result{ v, page.isNull() ? QImage() : page.copy(v.atlasRect) });
+        return results;
+    }
+
+    // el tamaño original sólo se decodifica si alguna variante lo usa; las
+    // escaladas se leen ya a su tamaño (SpriteCache::readScaled)
+    bool needBase = false;
+    for (const Variant &v : job.variants)
+        if (!v.size.isValid() || v.size.isEmpty()) needBase = true;
+    const QImage base = needBase ? QImageReader(job.file).read() : QImage();
+
+    for (const Variant &v : job.variants) {
+        QImage img = base;
+        if (v.size.isValid() && !v.size.isEmpty()) {
+            img = needBase ? (base.isNull() ? base : base.scaled(v.size, v.mode, Qt::SmoothTransformation))
+                           : SpriteCache::readScaled(job.file, v.size, v.mode);
+        }
+        if (!img.isNull()) {
+            // igual que SpriteCache: espejar después de escalar
+            if (v.flipX) img = img.mirrored(true, false);
+            // el formato nativo del pixmap: fromImage() ya no convierte en la GUI
+            img = img.convertToFormat(img.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                            : QImage::Format_RGB32);
+        }
+        results.append(Result{ v, img });
+    }
+    return results;
+}
+
+void AssetPreloader::deliver(const QVector<Result> &results)
+{
+    pending_ += results;
+    if (!batchTimer_->isActive()) batchTimer_->start();
+}
+
+void AssetPreloader::convertBatch()
+{
+    QElapsedTimer clock;
+    clock.start();
+
+    int converted = 0;
+    while (!pending_.isEmpty() && (converted == 0 || clock.elapsed() < kBatchBudgetMs)) {
+        Result r = pending_.takeLast();
+        // un nulo también se guarda: SpriteCache recuerda que el archivo no está
+        const QPixmap pix = r.image.isNull() ? QPixmap() : QPixmap::fromImage(std::move(r.image));
+        SpriteCache::insert(r.variant.path, r.variant.size, r.variant.mode, r.variant.flipX, pix);
+        ++converted;
+    }
+
+    done_ += converted;
+    emit progress(done_, total_);
+
+    // el resto en la siguiente vuelta del bucle de eventos (la GUI sigue fluida)
+    if (!pending_.isEmpty()) batchTimer_->start();
+    finishIfDone();
+}
+
+void AssetPreloader::finishIfDone()
+{
+    if (ready_ || done_ < total_) return;
+    ready_ = true;
+    emit ready();
+}
@@ -0,0 +1,67 @@
+#ifndef ASSETPRELOADER_H
+#define ASSETPRELOADER_H
+
+#pragma once
+#include <QImage>
+#include <QObject>
+#include <QRect>
+#include <QSize>
+#include <QThreadPool>
+#include <QVector>
+
+class QTimer;
+
+// Precarga de sprites mientras se muestra el menú. Los PNG se decodifican,
+// escalan y espejan como QImage en un pool de hilos; en el hilo de la GUI
+// sólo se pasan a QPixmap (lo único que no puede hacerse fuera) en tandas
+// cortas, y se dejan en SpriteCache con la misma clave que pedirá el juego.
+// Así entrar a un nivel ya no decodifica nada. Con los sprites cocinados
+// (SpriteAtlas) cada página se decodifica una vez y sólo se recorta.
+class AssetPreloader : public QObject {
+    Q_OBJECT
+public:
+    explicit AssetPreloader(QObject *parent = nullptr);
+    ~AssetPreloader() override;
+
+    void start();               // una sola vez; lo que ya esté en caché se salta
+    bool isReady() const { return ready_; }
+    int done() const { return done_; }
+    int total() const { return total_; }
+
+signals:
+    void progress(int done, int total);
+    void ready();
+
+private:
+    struct Variant {
+        QString path;           // clave de SpriteCache
+        QSize size;             // vacío = tamaño original
+        Qt::AspectRatioMode mode;
+        bool flipX;
+        QRect atlasRect;        // dentro de la página, si está cocinada
+    };
+    struct Job {
+        QString file;           // el PNG original o la página del atlas
+        bool atlas;
+        QVector<Variant> variants;
+    };
+    struct Result {
+        Variant variant;
+        QImage image;           // nula si el archivo no existe
+    };
+
+    static QVector<Result> decode(const Job &job);   // en el pool
+    void deliver(const QVector<Result> &results);      // hilo de la GUI
+    void convertBatch();
+    void finishIfDone();
+
+    QThreadPool pool_;
+    QVector<Result> pending_;   // decodificadas, aún sin pasar a QPixmap
+    QTimer *batchTimer_ = nullptr;
+    int total_ = 0;
+    int done_ = 0;
+    bool started_ = false;
+    bool ready_ = false;
+};
+
+#endif // ASSETPRELOADER_H
@@ -0,0 +1,72 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#pragma once
+#include <QSize>
+#include <cstddef>
+
+// Ids de los assets, armados en compilación desde AssetList.h: ruta, tamaño
+// y variante de cada uno están en tablas constexpr y resolver un id es
+// indexar un arreglo. Que los archivos existan lo comprueba qmake, así que
+// un asset que falta no llega a compilar.
+
+enum class SpriteId : quint8 {
+#define SPRITE(id, file, w, h, mode, flip) id,
+#define IMAGE(id, file) id,
+#define MUSIC(id, file)
+#include "AssetList.h"
+#undef SPRITE
+#undef IMAGE
+#undef MUSIC
+    Count
+};
+
+enum class MusicTrack : quint8 {
+#define SPRITE(id, file, w, h, mode, flip)
+#define IMAGE(id, file)
+#define MUSIC(id, file) id,
+#include "AssetList.h"
+#undef SPRITE
+#undef IMAGE
+#undef MUSIC
+    Count
+};
+
+struct SpriteDef {
+    const char *path;           // ruta del recurso, lista para SpriteCache
+    int width;                  // 0 = tamaño original
+    int height;
+    Qt::AspectRatioMode mode;
+    bool flipX;
+    bool sprite;                // false: IMAGE, el archivo se usa tal cual
+
+    constexpr QSize size() const { return width > 0 ? QSize(width, height) : QSize(); }
+};
+
+inline constexpr SpriteDef kSpriteDefs[] = {
+#define SPRITE(id, file, w, h, mode, flip) { ":/images/" file, w, h, Qt::mode##AspectRatio, flip, true },
+#define IMAGE(id, file) { ":/images/" file, 0, 0, Qt::IgnoreAspectRatio, false, false },
+#define MUSIC(id, file)
+#include "AssetList.h"
+#undef SPRITE
+#undef IMAGE
+#undef MUSIC
+};
+
+inline constexpr const char *kMusicPaths[] = {
+#define SPRITE(id, file, w, h, mode, flip)
+#define IMAGE(id, file)
+#define MUSIC(id, file) ":/sound/" file,
+#include "AssetList.h"
+#undef SPRITE
+#undef IMAGE
+#undef MUSIC
+};
+
+constexpr const SpriteDef &spriteDef(SpriteId id) { return kSpriteDefs[static_cast<std::size_t>(id)]; }
+constexpr const char *musicPath(MusicTrack track) { return kMusicPaths[static_cast<std::size_t>(track)]; }
+
+// Consecutivos en AssetList.h: vida N = Life1 + N - 1
+static_assert(int(SpriteId::Life6) - int(SpriteId::Life1) == 5, "las vidas tienen que ir seguidas");
+
+#endif // ASSETS_H
@@ -0,0 +1,333 @@
+#include "AudioMixer.h"
+#include "GameWorld.h"
+#include <QAudioFormat>
+#include <QAudioSink>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QIODevice>
+#include <QMediaDevices>
+#include <QThread>
+#include <algorithm>
+
+// Definición de cada SoundId (mismo orden que el enum). maxInstances limita
+// cuántas voces puede ocupar un mismo efecto; con retrigger, el efecto que
+// llega con el cupo lleno reinicia su voz más antigua, si no se ignora
+// (el lanzallamas no vuelve a empezar mientras suena).
+struct SoundDef {
+    const char *name;       // en sounds/efectos.bank
+    SoundCategory category;
+    quint8 priority;        // mayor gana al robar voces
+    quint8 maxInstances;
+    bool retrigger;
+};
+static const SoundDef kSoundDefs[] = {
+    /* PlayerShot   */ { "arma_player",    SoundCategory::Weapons,    1, 4, true  },
+    /* EnemyShot    */ { "arma_enemigo",   SoundCategory::Weapons,    0, 4, true  },
+    /* Explosion    */ { "granada",        SoundCategory::Explosions, 3, 3, true  },
+    /* EnemyDeath   */ { "muerte_enemigo", SoundCategory::Voices,     2, 4, true  },
+    /* Flamethrower */ { "lanzallamas",    SoundCategory::Weapons,    2, 1, false },
+};
+static_assert(sizeof(kSoundDefs) / sizeof(kSoundDefs[0]) == static_cast<int>(SoundId::Count),
+              "falta la definición de algún SoundId");
+
+static const char *const kBankPath = ":/sound/efectos.bank";
+static const int kChannels = 2;
+static const int kMaxBlockFrames = 4096;   // lo que se mezcla de una vez
+static const int kLatencyMs = 40;          // tamaño del búfer del QAudioSink
+
+static AudioMixer *s_instance = nullptr;
+
+// ----------------------------
+// Dispositivo en modo pull: el QAudioSink le pide bytes desde el hilo de
+// audio y cada lectura mezcla un bloque nuevo.
+// ----------------------------
+class MixerDevice : public QIODevice {
+public:
+    explicit MixerDevice(AudioMixer *mixer) : mixer_(mixer) {}
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override
+    {
+        return qint64(kMaxBlockFrames) * kChannels * sizeof(qint16) + QIODevice::bytesAvailable();
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override
+    {
+        const int frameBytes = kChannels * sizeof(qint16);
+        qint64 done = 0;
+        while (maxlen - done >= frameBytes) {
+            const int frames = int(qMin<qint64>((maxlen - done) / frameBytes, kMaxBlockFrames));
+            mixer_->render(reinterpret_cast<qint16*>(data + done), frames);
+            done += qint64(frames) * frameBytes;
+        }
+        return done;
+    }
+
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    AudioMixer *mixer_;
+};
+
+// ----------------------------
+// Ciclo de vida
+// ----------------------------
+AudioMixer *AudioMixer::instance()
+{
+    if (!s_instance) s_instance = new AudioMixer(qApp);
+    return s_instance;
+}
+
+AudioMixer::AudioMixer(QObject *parent)
+    : QObject(parent)
+{
+    for (auto &v : categoryVolume_) v.store(1.0f, std::memory_order_relaxed);
+    mix_.resize(kMaxBlockFrames * kChannels);
+    music_ = new MusicStream;
+
+    thread_ = new QThread(this);
+    thread_->setObjectName(QStringLiteral("AudioMixer"));
+    device_ = new MixerDevice(this);
+    device_->moveToThread(thread_);
+    thread_->start(QThread::TimeCriticalPriority);
+
+    // decodificar y abrir la salida ya dentro del hilo de audio
+    QMetaObject::invokeMethod(device_, [this] { startOutput(); }, Qt::QueuedConnection);
+}
+
+AudioMixer::~AudioMixer()
+{
+    if (thread_->isRunning()) {
+        QMetaObject::invokeMethod(device_, [this] { stopOutput(); }, Qt::BlockingQueuedConnection);
+        thread_->quit();
+        thread_->wait();
+    }
+    delete music_;   // el hilo de audio ya no lo lee
+    delete device_;
+    s_instance = nullptr;
+}
+
+void AudioMixer::startOutput()
+{
+    const QAudioDevice out = QMediaDevices::defaultAudioOutput();
+    if (out.isNull()) {
+        qWarning() << "AudioMixer: no hay dispositivo de salida";
+        return;
+    }
+
+    QAudioFormat fmt;
+    fmt.setChannelCount(kChannels);
+    fmt.setSampleFormat(QAudioFormat::Int16);
+    fmt.setSampleRate(48000);
+    if (!out.isFormatSupported(fmt)) fmt.setSampleRate(44100);
+    if (!out.isFormatSupported(fmt)) {
+        qWarning() << "AudioMixer: el dispositivo no acepta estéreo de 16 bits";
+        return;
+    }
+
+    // el banco se mapea entero; las voces lo leen (y decodifican) al mezclar
+    QString error;
+    if (bank_.open(QString::fromLatin1(kBankPath), &error)) {
+        srcStep_ = float(bank_.sampleRate()) / fmt.sampleRate();
+        bankBytes_.store(bank_.bytes(), std::memory_order_relaxed);
+        bankMapped_.store(bank_.isMapped(), std::memory_order_relaxed);
+        for (int i = 0; i < static_cast<int>(SoundId::Count); ++i) {
+            sounds_[i] = bank_.clip(kSoundDefs[i].name);
+            if (sounds_[i].isNull()) qWarning() << "AudioMixer: falta" << kSoundDefs[i].name << "en el banco";
+        }
+    } else {
+        qWarning().noquote() << QString("AudioMixer: no se pudo abrir %1: %2").arg(kBankPath, error);
+    }
+
+    music_->setOutputRate(fmt.sampleRate());
+
+    device_->open(QIODevice::ReadOnly);
+    sink_ = new QAudioSink(out, fmt, device_);
+    sink_->setBufferSize(fmt.bytesForDuration(qint64(kLatencyMs) * 1000));
+    sink_->start(device_);
+    running_.store(sink_->error() == QAudio::NoError, std::memory_order_release);
+}
+
+void AudioMixer::stopOutput()
+{
+    running_.store(false, std::memory_order_release);
+    if (sink_) {
+        sink_->stop();
+        delete sink_;
+        sink_ = nullptr;
+    }
+    device_->close();
+}
+
+// ----------------------------
+// Hilo de la GUI: encolar sin bloquear
+// ----------------------------
+bool AudioMixer::enqueue(const Command &c)
+{
+    const quint32 tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == kQueueSize) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    queue_[tail & (kQueueSize - 1)] = c;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+void AudioMixer::play(SoundId id, float gain)
+{
+    if (!GameWorld::audioAllowed()) return;
+    instance()->enqueue({ Op::Play, id, gain });
+}
+
+void AudioMixer::stop(SoundId id)
+{
+    if (!s_instance) return;
+    s_instance->enqueue({ Op::Stop, id, 0.0f });
+}
+
+void AudioMixer::playMusic(MusicTrack track, float volume, int fadeMs, bool loop)
+{
+    if (!GameWorld::audioAllowed()) return;
+    instance()->music_->play(track, volume, fadeMs, loop);
+}
+
+void AudioMixer::stopMusic(int fadeMs)
+{
+    if (!s_instance) return;
+    s_instance->music_->stop(fadeMs);
+}
+
+void AudioMixer::setCategoryVolume(SoundCategory c, float volume)
+{
+    categoryVolume_[static_cast<int>(c)].store(qBound(0.0f, volume, 1.0f), std::memory_order_relaxed);
+}
+
+float AudioMixer::categoryVolume(SoundCategory c) const
+{
+    return categoryVolume_[static_cast<int>(c)].load(std::memory_order_relaxed);
+}
+
+AudioMixer::Stats AudioMixer::stats() const
+{
+    Stats s;
+    s.activeVoices = activeVoices_.load(std::memory_order_relaxed);
+    s.stolen = stolen_.load(std::memory_order_relaxed);
+    s.dropped = dropped_.load(std::memory_order_relaxed);
+    s.musicUnderruns = music_->underruns();
+    s.bankBytes = bankBytes_.load(std::memory_order_relaxed);
+    s.bankMapped = bankMapped_.load(std::memory_order_relaxed);
+    s.running = running_.load(std::memory_order_acquire);
+    return s;
+}
+
+// ----------------------------
+// Hilo de audio: voces y mezcla
+// ----------------------------
+void AudioMixer::startVoice(SoundId id, float gain)
+{
+    const int index = static_cast<int>(id);
+    const SoundDef &def = kSoundDefs[index];
+    if (sounds_[index].isNull()) return;
+
+    // cupo por efecto: reiniciar la más antigua o ignorar
+    int same = 0;
+    Voice *oldest = nullptr;
+    for (Voice &v : voices_) {
+        if (v.sound != index) continue;
+        ++same;
+        if (!oldest || v.cursor.position() > oldest->cursor.position()) oldest = &v;
+    }
+    if (same >= def.maxInstances) {
+        if (def.retrigger) restartVoice(*oldest, index, gain);
+        return;
+    }
+
+    // voz libre o, si no hay, la de menor prioridad (y más avanzada)
+    Voice *target = nullptr;
+    for (Voice &v : voices_) {
+        if (v.sound < 0) { target = &v; break; }
+        if (!target) { target = &v; continue; }
+        const int pv = kSoundDefs[v.sound].priority;
+        const int pt = kSoundDefs[target->sound].priority;
+        if (pv < pt || (pv == pt && v.cursor.position() > target->cursor.position())) target = &v;
+    }
+    if (target->sound >= 0) {
+        if (kSoundDefs[target->sound].priority > def.priority) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        stolen_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    restartVoice(*target, index, gain);
+}
+
+void AudioMixer::restartVoice(Voice &v, int sound, float gain)
+{
+    v.sound = sound;
+    v.gain = gain;
+    v.cursor.reset(sounds_[sound]);
+    v.s0 = v.cursor.next();
+    v.s1 = v.cursor.atEnd() ? 0.0f : v.cursor.next();
+    v.frac = 0.0f;
+    v.tail = 0;
+}
+
+void AudioMixer::render(qint16 *out, int frames)
+{
+    // órdenes pendientes de la GUI
+    quint32 head = head_.load(std::memory_order_relaxed);
+    const quint32 tail = tail_.load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+        const Command &c = queue_[head & (kQueueSize - 1)];
+        if (c.op == Op::Play) {
+            startVoice(c.id, c.gain);
+        } else {
+            for (Voice &v : voices_)
+                if (v.sound == static_cast<int>(c.id)) v.sound = -1;
+        }
+    }
+    head_.store(head, std::memory_order_release);
+
+    float category[static_cast<int>(SoundCategory::Count)];
+    for (int c = 0; c < static_cast<int>(SoundCategory::Count); ++c)
+        category[c] = categoryVolume_[c].load(std::memory_order_relaxed);
+
+    const int samples = frames * kChannels;
+    float *mix = mix_.data();
+    std::fill(mix, mix + samples, 0.0f);
+
+    // clips mono a la frecuencia del banco: interpolación lineal a la de salida
+    int active = 0;
+    for (Voice &v : voices_) {
+        if (v.sound < 0) continue;
+        const float g = v.gain * category[static_cast<int>(kSoundDefs[v.sound].category)];
+        for (int i = 0; i < frames; ++i) {
+            const float s = (v.s0 + (v.s1 - v.s0) * v.frac) * g;
+            mix[i * kChannels] += s;
+            mix[i * kChannels + 1] += s;
+
+            v.frac += srcStep_;
+            while (v.frac >= 1.0f) {
+                v.frac -= 1.0f;
+                v.s0 = v.s1;
+                if (!v.cursor.atEnd()) v.s1 = v.cursor.next();
+                else { v.s1 = 0.0f; ++v.tail; }
+            }
+            // ya salió la última muestra del clip
+            if (v.tail >= 2) {
+                v.sound = -1;
+                break;
+            }
+        }
+        if (v.sound >= 0) ++active;
+    }
+    activeVoices_.store(active, std::memory_order_relaxed);
+
+    music_->mix(mix, frames, category[static_cast<int>(SoundCategory::Music)]);
+
+    for (int i = 0; i < samples; ++i)
+        out[i] = qint16(qBound(-32768.0f, mix[i], 32767.0f));
+}
@@ -0,0 +1,137 @@
+#ifndef AUDIOMIXER_H
+#define AUDIOMIXER_H
+
+#pragma once
+#include <QObject>
+#include <QVector>
+#include <atomic>
+#include "MusicStream.h"
+#include "SoundBank.h"
+
+class QThread;
+class QAudioSink;
+class MixerDevice;
+
+// Efectos que conoce el mezclador (tabla kSoundDefs en AudioMixer.cpp)
+enum class SoundId : quint8 {
+    PlayerShot,
+    EnemyShot,
+    Explosion,
+    EnemyDeath,
+    Flamethrower,
+    Count
+};
+
+// Cada efecto pertenece a una categoría con su propio volumen
+enum class SoundCategory : quint8 {
+    Weapons,
+    Explosions,
+    Voices,
+    Music,
+    Count
+};
+
+// Mezclador por software: un solo QAudioSink alimentado desde un hilo de
+// audio propio y un número fijo de voces. Los efectos salen del banco
+// mapeado (SoundBank): cada voz decodifica su clip mientras suena.
+//
+// El juego sólo encola órdenes (id, ganancia) en una cola circular sin
+// bloqueos de un productor y un consumidor: play()/stop() se llaman siempre
+// desde el hilo de la GUI y el hilo de audio las recoge al mezclar cada
+// bloque. Si no hay voz libre se roba la de menor prioridad (y, entre
+// iguales, la más avanzada); si todas valen más, el efecto se descarta.
+//
+// La música no pasa por las voces: la lee MusicStream en streaming y se
+// suma a la mezcla con el volumen de SoundCategory::Music.
+class AudioMixer : public QObject {
+public:
+    static constexpr int kVoices = 16;
+
+    struct Stats {
+        int activeVoices = 0;
+        quint32 stolen = 0;    // voces robadas a un efecto de menor prioridad
+        quint32 dropped = 0;   // cola llena o sin voz que robar
+        quint32 musicUnderruns = 0;
+        qint64 bankBytes = 0;  // banco de efectos residente
+        bool bankMapped = false;
+        bool running = false;  // el dispositivo de salida arrancó
+    };
+
+    // Crea el mezclador la primera vez (hijo de qApp). No lo uses en modo
+    // headless: play()/stop() ya lo comprueban con GameWorld::audioAllowed().
+    static AudioMixer *instance();
+
+    static void play(SoundId id, float gain = 1.0f);
+    static void stop(SoundId id);   // corta todas las voces de ese efecto
+
+    // Fundido cruzado desde lo que esté sonando (fadeMs = 0: corte seco)
+    static void playMusic(MusicTrack track, float volume = 1.0f, int fadeMs = 0, bool loop = true);
+    static void stopMusic(int fadeMs = 0);
+
+    void setCategoryVolume(SoundCategory c, float volume);
+    float categoryVolume(SoundCategory c) const;
+
+    Stats stats() const;
+
+private:
+    explicit AudioMixer(QObject *parent);
+    ~AudioMixer() override;
+
+    friend class MixerDevice;
+
+    enum class Op : quint8 { Play, Stop };
+    struct Command {
+        Op op;
+        SoundId id;
+        float gain;
+    };
+
+    struct Voice {
+        int sound = -1;         // -1: libre
+        SoundBank::Cursor cursor;
+        float s0 = 0.0f;        // muestras del clip a ambos lados de 'frac'
+        float s1 = 0.0f;
+        float frac = 0.0f;
+        int tail = 0;           // muestras pedidas más allá del final
+        float gain = 0.0f;
+    };
+
+    // --- hilo de la GUI ---
+    bool enqueue(const Command &c);
+
+    // --- hilo de audio ---
+    void startOutput();
+    void stopOutput();
+    void render(qint16 *out, int frames);
+    void startVoice(SoundId id, float gain);
+    void restartVoice(Voice &v, int sound, float gain);
+
+    // Cola SPSC: la GUI sólo escribe tail_, el audio sólo escribe head_
+    static constexpr quint32 kQueueSize = 128;   // potencia de 2
+    Command queue_[kQueueSize];
+    std::atomic<quint32> head_{0};
+    std::atomic<quint32> tail_{0};
+
+    std::atomic<float> categoryVolume_[static_cast<int>(SoundCategory::Count)];
+    std::atomic<int> activeVoices_{0};
+    std::atomic<quint32> stolen_{0};
+    std::atomic<quint32> dropped_{0};
+    std::atomic<bool> running_{false};
+    std::atomic<qint64> bankBytes_{0};
+    std::atomic<bool> bankMapped_{false};
+
+    // Sólo los toca el hilo de audio
+    SoundBank bank_;
+    SoundBank::Clip sounds_[static_cast<int>(SoundId::Count)];
+    float srcStep_ = 1.0f;      // frames del banco por frame de salida
+    Voice voices_[kVoices];
+    QVector<float> mix_;
+
+    MusicStream *music_ = nullptr;
+
+    QThread *thread_ = nullptr;
+    MixerDevice *device_ = nullptr;
+    QAudioSink *sink_ = nullptr;
+};
+
+#endif // AUDIOMIXER_H
@@ -0,0 +1,46 @@
+#include "BroadphaseOverlay.h"
+#include "GameWorld.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+BroadphaseOverlay::BroadphaseOverlay(GameWorld *world, QGraphicsItem *parent)
+    : QGraphicsItem(parent), world_(world)
+{
+    setZValue(1000);                 // encima de todo
+    setAcceptedMouseButtons(Qt::NoButton);
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption); // exposedRect real: sólo celdas visibles
+}
+
+QRectF BroadphaseOverlay::boundingRect() const
+{
+    return world_ ? world_->broadphase().bounds() : QRectF();
+}
+
+void BroadphaseOverlay::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+    if (!world_) return;
+
+    const SpatialHash &grid = world_->broadphase();
+    const QRectF b = grid.bounds();
+    const qreal cs = grid.cellSize();
+
+    painter->setPen(QPen(QColor(255, 255, 255, 50), 0));
+    QFont f = painter->font();
+    f.setPixelSize(11);
+    painter->setFont(f);
+
+    for (int cy = 0; cy < grid.rows(); ++cy) {
+        for (int cx = 0; cx < grid.columns(); ++cx) {
+            const QRectF cell(b.left() + cx * cs, b.top() + cy * cs, cs, cs);
+            if (!cell.intersects(option->exposedRect)) continue;
+
+            const int n = grid.cellOccupancy(cx, cy);
+            if (n > 0) {
+                painter->fillRect(cell, QColor(255, 80, 0, qMin(40 + 35 * n, 200)));
+                painter->drawText(cell.adjusted(3, 2, 0, 0), Qt::AlignLeft | Qt::AlignTop, QString::number(n));
+            }
+            painter->drawRect(cell);
+        }
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef BROADPHASEOVERLAY_H
+#define BROADPHASEOVERLAY_H
+
+#pragma once
+#include <QGraphicsItem>
+#include <QPointer>
+
+class GameWorld;
+
+// Depuración (F3): dibuja la rejilla de la broadphase del mundo encima de la
+// escena; cada celda se tiñe según cuántos colliders tiene y muestra el número.
+class BroadphaseOverlay : public QGraphicsItem {
+public:
+    explicit BroadphaseOverlay(GameWorld *world, QGraphicsItem *parent = nullptr);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    QPointer<GameWorld> world_;
+};
+
+#endif // BROADPHASEOVERLAY_H
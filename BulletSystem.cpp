@@ -0,0 +1,419 @@
+#include "BulletSystem.h"
+#include "GameWorld.h"
+#include "SpriteBatchItem.h"
+#include "SpriteCache.h"
+#include <QPainterPath>
+#include <QPolygonF>
+#include <QtMath>
+#include <QDebug>
+#include <algorithm>
+
+#include "AudioMixer.h"
+
+#include "PlayerItem.h"
+#include "EnemyItem.h"
+
+#include <BunkerBossItem.h>
+#include "TopDownEnemy.h"
+#include "TopDownPlayerItem.h"
+#include "CoverItem.h"
+
+// Núcleos de integración según el conjunto de instrucciones del compilado
+// (AVX2 se activa con CONFIG+=bullets_avx2, ver interfaz.pro). Sólo se usan
+// sumas y productos separados (sin FMA): el resultado es bit a bit el mismo
+// que el del bucle escalar, así las repeticiones no dependen de la máquina.
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#  define BULLETS_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define BULLETS_SSE2 1
+#endif
+
+static const float kLifeTime = 2.0f;
+
+// Sprite de cada BulletSystem::Visual (mismo orden que el enum). No hay
+// imagen de bala enemiga: las tres usan la del jugador
+static const SpriteId kVisualDefs[] = {
+    /* Player     */ SpriteId::Bullet,
+    /* Enemy      */ SpriteId::Bullet,
+    /* EnemySmall */ SpriteId::Bullet,
+};
+static_assert(sizeof(kVisualDefs) / sizeof(kVisualDefs[0]) == static_cast<int>(BulletSystem::Visual::Count),
+              "falta la definición de algún BulletSystem::Visual");
+// fuera de esto la bala ya no vuelve a verse
+static const float kMinX = -200.0f, kMaxX = 3000.0f;
+static const float kMinY = -200.0f, kMaxY = 2000.0f;
+
+// ----------------------------
+// Respuestas de impacto (una por par dueño/categoría)
+// El tipo del item ya viene garantizado por su categoría: static_cast directo.
+// ----------------------------
+static bool hitCover(const QPointF &b, QGraphicsItem *it)
+{
+    // sólo frena si la bala va a la altura del rectángulo
+    const CoverItem *r = static_cast<CoverItem*>(it);
+    qreal topY = it->pos().y();
+    qreal bottomY = topY + r->rect().height();
+    qreal bulletY = b.y();
+
+    if (bulletY >= topY && bulletY <= bottomY) {
+        qDebug() << "Bullet blocked by bunker at y" << bulletY;
+        return true;
+    }
+    return false;
+}
+
+// === Enemigos Rojos (Nivel 2) ===
+static bool hitRedEnemy(const QPointF &, QGraphicsItem *it)
+{
+    static_cast<TopDownEnemy*>(it)->takeDamage(1);
+    return true;
+}
+
+// === Enemigo (Nivel 1) ===
+static bool hitSoldier(const QPointF &b, QGraphicsItem *it)
+{
+    EnemyItem *enemy = static_cast<EnemyItem*>(it);
+    if (!enemy->isAlive()) return false;
+
+    // Si el enemigo está agachado, comprobamos si la bala impacta por encima
+    if (enemy->isCrouching()) {
+        // pos().y() del enemy es la línea de los pies; la parte protegida va desde (feetY - protectionHeight) hasta feetY
+        double feetY = enemy->pos().y();
+        double protectionH = static_cast<double>(enemy->crouchProtectionHeight());
+        double protectionTopY = feetY - protectionH;
+        double bulletY = b.y();
+
+        // Si la bala está por debajo o dentro de la zona protegida -> se bloquea (no daño)
+        // recordá: en coordenadas Qt, y aumenta hacia abajo
+        if (bulletY >= protectionTopY && bulletY <= feetY) {
+            qDebug() << "Bullet hit crouched enemy (blocked) at y" << bulletY;
+            return true;
+        }
+        // si la bala vino por encima de protectionTopY, aplica daño abajo
+    }
+
+    enemy->takeDamage(1);
+    return true;
+}
+
+static bool hitBunker(const QPointF &, QGraphicsItem *it)
+{
+    static_cast<BunkerBossItem*>(it)->takeDamage(1); // Daño de la bala
+    return true;
+}
+
+// === Jugador de plataformas ===
+static bool hitPlayer(const QPointF &, QGraphicsItem *it)
+{
+    qDebug() << "Player hit by enemy bullet!";
+    static_cast<PlayerItem*>(it)->takeDamage(1);
+    return true;
+}
+
+// === Jugador Top-Down (Nivel 2) ===
+static bool hitTopDownPlayer(const QPointF &, QGraphicsItem *it)
+{
+    static_cast<TopDownPlayerItem*>(it)->takeDamage(1);
+    return true;
+}
+
+// Filas: dueño de la bala. Columnas: CollisionCategory. nullptr = no interactúan
+// (sin friendly fire: las balas del jugador no ven jugadores y viceversa).
+const BulletSystem::HitFn BulletSystem::kHitTable[2][static_cast<int>(CollisionCategory::Count)] = {
+    //            None     Player     TopDownPlayer     Soldier     RedEnemy     Bunker     Cover
+    /* Player */ { nullptr, nullptr,   nullptr,          hitSoldier, hitRedEnemy, hitBunker, hitCover },
+    /* Enemy  */ { nullptr, hitPlayer, hitTopDownPlayer, nullptr,    nullptr,     nullptr,   hitCover },
+};
+
+quint32 BulletSystem::hitMask(Owner owner)
+{
+    const int row = static_cast<int>(owner);
+    quint32 m = 0;
+    for (int c = 0; c < static_cast<int>(CollisionCategory::Count); ++c) {
+        if (kHitTable[row][c]) m |= categoryBit(static_cast<CollisionCategory>(c));
+    }
+    return m;
+}
+
+// ----------------------------
+// Integración: p += v*dt, vida -= dt
+// ----------------------------
+static void integrate(float *px, float *py, const float *vx, const float *vy,
+                      float *life, int n, float dt)
+{
+    int i = 0;
+#ifdef BULLETS_AVX2
+    const __m256 dt8 = _mm256_set1_ps(dt);
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(px + i, _mm256_add_ps(_mm256_loadu_ps(px + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), dt8)));
+        _mm256_storeu_ps(py + i, _mm256_add_ps(_mm256_loadu_ps(py + i), _mm256_mul_ps(_mm256_loadu_ps(vy + i), dt8)));
+        _mm256_storeu_ps(life + i, _mm256_sub_ps(_mm256_loadu_ps(life + i), dt8));
+    }
+#endif
+#ifdef BULLETS_SSE2
+    const __m128 dt4 = _mm_set1_ps(dt);
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(_mm_loadu_ps(vx + i), dt4)));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(_mm_loadu_ps(vy + i), dt4)));
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dt4));
+    }
+#endif
+    // resto (o todo, sin SIMD)
+    for (; i < n; ++i) {
+        px[i] += vx[i] * dt;
+        py[i] += vy[i] * dt;
+        life[i] -= dt;
+    }
+}
+
+const char *BulletSystem::kernelName()
+{
+#if defined(BULLETS_AVX2)
+    return "avx2";
+#elif defined(BULLETS_SSE2)
+    return "sse2";
+#else
+    return "escalar";
+#endif
+}
+
+// ----------------------------
+// BulletSystem
+// ----------------------------
+BulletSystem::BulletSystem(GameWorld *world)
+    : world_(world)
+{
+    px_.reserve(kCapacity);
+    py_.reserve(kCapacity);
+    vx_.reserve(kCapacity);
+    vy_.reserve(kCapacity);
+    life_.reserve(kCapacity);
+    owner_.reserve(kCapacity);
+    visual_.reserve(kCapacity);
+    instance_.reserve(kCapacity);
+}
+
+BulletSystem::~BulletSystem()
+{
+    clear();
+}
+
+void BulletSystem::prepareVisuals()
+{
+    if (visualsReady_) return;
+    visualsReady_ = true;
+
+    for (int v = 0; v < static_cast<int>(Visual::Count); ++v) {
+        VisualData &vd = visuals_[v];
+        vd.pixmap = SpriteCache::get(kVisualDefs[v]);
+        if (!vd.pixmap.isNull()) {
+            vd.halfW = vd.pixmap.width() * 0.5f;
+            vd.halfH = vd.pixmap.height() * 0.5f;
+        }
+    }
+}
+
+int BulletSystem::spawn(const QPointF &pos, const QPointF &dir, double speed, Owner owner, Visual visual)
+{
+    if (px_.size() >= kCapacity) {
+        ++rejected_;
+        return -1;
+    }
+
+    // normalizar dirección si no es unit vector
+    QPointF d = dir;
+    double len = std::hypot(d.x(), d.y());
+    if (len <= 0.0001) d = QPointF(1, 0);
+    else d /= len;
+
+    // una instancia en el lote de su textura, no un item propio
+    prepareVisuals();
+    VisualData &vd = visuals_[static_cast<int>(visual)];
+    if (!vd.batch && world_) vd.batch = world_->sprites().batchFor(vd.pixmap, 50);
+    const int instance = vd.batch ? vd.batch->addInstance(pos) : -1;
+
+    px_.append(float(pos.x()));
+    py_.append(float(pos.y()));
+    vx_.append(float(d.x() * speed));
+    vy_.append(float(d.y() * speed));
+    life_.append(kLifeTime);
+    owner_.append(static_cast<quint8>(owner));
+    visual_.append(static_cast<quint8>(visual));
+    instance_.append(instance);
+    peak_ = qMax(peak_, int(px_.size()));
+
+    // las balas enemigas suenan desde quien dispara
+    if (owner == Owner::Player) AudioMixer::play(SoundId::PlayerShot, 0.9f);
+
+    return px_.size() - 1;
+}
+
+void BulletSystem::step(double dt)
+{
+    const int n = px_.size(); // las que nazcan durante el paso esperan al siguiente
+    if (n == 0) return;
+
+    integrate(px_.data(), py_.data(), vx_.data(), vy_.data(), life_.data(), n, float(dt));
+
+    // Una sola pasada: descartar vencidas / fuera de escena / que chocaron y
+    // compactar las vivas hacia adelante.
+    const quint64 generation = generation_;
+    int w = 0;
+    for (int i = 0; i < n; ++i) {
+        const float x = px_[i], y = py_[i];
+        bool dead = life_[i] < 0.0f || x < kMinX || x > kMaxX || y < kMinY || y > kMaxY;
+        if (!dead) {
+            dead = collide(i, float(dt));
+            if (generation != generation_) return; // un impacto reinició el nivel
+        }
+
+        if (dead) {
+            destroy(i);
+            continue;
+        }
+        move(i, w++);
+    }
+
+    // disparos hechos por un impacto a mitad de pasada
+    for (int i = n; i < px_.size(); ++i) move(i, w++);
+    resizeAll(w);
+}
+
+// Lo que barre una caja al trasladarse por 'd': la envolvente convexa de la
+// caja al principio y al final (un hexágono, o la caja si no se movió)
+static QPolygonF sweptBox(const QRectF &box, const QPointF &d)
+{
+    const QRectF end = box.translated(d);
+    QPointF pts[8] = { box.topLeft(), box.topRight(), box.bottomRight(), box.bottomLeft(),
+                       end.topLeft(), end.topRight(), end.bottomRight(), end.bottomLeft() };
+    std::sort(pts, pts + 8, [](const QPointF &a, const QPointF &b) {
+        return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+    });
+    auto cross = [](const QPointF &o, const QPointF &a, const QPointF &b) {
+        return (a.x() - o.x()) * (b.y() - o.y()) - (a.y() - o.y()) * (b.x() - o.x());
+    };
+    // cadena monótona
+    QPointF hull[16];
+    int k = 0;
+    for (int i = 0; i < 8; ++i) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0) --k;
+        hull[k++] = pts[i];
+    }
+    for (int i = 6, lower = k + 1; i >= 0; --i) {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0) --k;
+        hull[k++] = pts[i];
+    }
+    return QPolygonF(QVector<QPointF>(hull, hull + k - 1));
+}
+
+bool BulletSystem::collide(int i, float dt)
+{
+    if (!world_) return false;
+
+    // Barrido continuo: el tramo recorrido en este paso (a -> b), no sólo la
+    // posición final, así una bala rápida o un dt grande no atraviesa una
+    // pared de 20 px
+    const QPointF b(px_[i], py_[i]);
+    const QPointF a(px_[i] - vx_[i] * dt, py_[i] - vy_[i] * dt);
+    const VisualData &vd = visuals_[visual_[i]];
+    const QRectF box(a.x() - vd.halfW, a.y() - vd.halfH, 2.0 * vd.halfW, 2.0 * vd.halfH);
+    const QPointF d = b - a;
+    const Owner owner = static_cast<Owner>(owner_[i]);
+    const int row = static_cast<int>(owner);
+
+    // Candidatos de la broadphase del mundo (ya filtrados por la máscara del
+    // dueño) en la caja que cubre todo el tramo
+    SpatialHash::Candidates candidates;
+    world_->broadphase().query(box.united(box.translated(d)), hitMask(owner), candidates);
+    if (candidates.isEmpty()) return false;
+
+    // Tiempo de impacto de cada uno: donde la caja de la bala empieza a tocar
+    // la caja del item (segmento contra la caja inflada por la de la bala).
+    // La prueba exacta de forma es con todo lo barrido.
+    struct Hit { double t; QGraphicsItem *item; };
+    QVarLengthArray<Hit, 16> hits;
+    QPainterPath swept;
+    swept.addPolygon(sweptBox(box, d));
+    for (QGraphicsItem *it : candidates) {
+        const QRectF inflated = it->sceneBoundingRect().adjusted(-vd.halfW, -vd.halfH, vd.halfW, vd.halfH);
+        double t;
+        if (!segmentHitsRect(a, b, inflated, &t)) continue;
+        if (!it->collidesWithPath(it->mapFromScene(swept), Qt::IntersectsItemShape)) continue;
+        hits.append({ t, it });
+    }
+
+    // el primer impacto que consume la bala la detiene ahí
+    std::sort(hits.begin(), hits.end(), [](const Hit &x, const Hit &y) { return x.t < y.t; });
+    for (const Hit &h : hits) {
+        const QPointF p = a + d * h.t;
+        if (kHitTable[row][static_cast<int>(collisionCategory(h.item))](p, h.item)) {
+            px_[i] = float(p.x());
+            py_[i] = float(p.y());
+            return true;
+        }
+    }
+    return false;
+}
+
+void BulletSystem::destroy(int i)
+{
+    SpriteBatchItem *batch = visuals_[visual_[i]].batch;
+    if (batch) batch->removeInstance(instance_[i]);
+    instance_[i] = -1;
+}
+
+void BulletSystem::move(int from, int to)
+{
+    if (from == to) return;
+    px_[to] = px_[from];
+    py_[to] = py_[from];
+    vx_[to] = vx_[from];
+    vy_[to] = vy_[from];
+    life_[to] = life_[from];
+    owner_[to] = owner_[from];
+    visual_[to] = visual_[from];
+    instance_[to] = instance_[from];
+}
+
+void BulletSystem::resizeAll(int n)
+{
+    px_.resize(n);
+    py_.resize(n);
+    vx_.resize(n);
+    vy_.resize(n);
+    life_.resize(n);
+    owner_.resize(n);
+    visual_.resize(n);
+    instance_.resize(n);
+}
+
+void BulletSystem::syncVisuals()
+{
+    for (int i = 0; i < visual_.size(); ++i) {
+        if (SpriteBatchItem *batch = visuals_[visual_[i]].batch)
+            batch->setInstance(instance_[i], QPointF(px_[i], py_[i]));
+    }
+}
+
+void BulletSystem::clear()
+{
+    ++generation_;
+    resizeAll(0);
+    // los lotes eran de la escena del nivel: se piden de nuevo en el siguiente
+    for (VisualData &vd : visuals_) vd.batch = nullptr;
+}
+
+void BulletSystem::hashState(StateHash &h) const
+{
+    h.addInt(px_.size());
+    for (int i = 0; i < px_.size(); ++i) {
+        h.addReal(px_[i]);
+        h.addReal(py_[i]);
+        h.addReal(vx_[i]);
+        h.addReal(vy_[i]);
+        h.addInt(owner_[i]);
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef BULLETSYSTEM_H
+#define BULLETSYSTEM_H
+
+#pragma once
+#include <QPixmap>
+#include <QPointF>
+#include <QVector>
+#include "Collision.h"
+
+class QGraphicsItem;
+class GameWorld;
+class SpriteBatchItem;
+class StateHash;
+
+// Todas las balas del nivel en arreglos contiguos (una columna por campo):
+// posición, velocidad, vida restante y dueño. GameWorld las avanza juntas en
+// la fase de proyectiles: integración vectorizada (AVX2 / SSE2 / escalar,
+// según con qué se compile) y luego una sola pasada que descarta las que
+// salieron de la escena, vencieron o chocaron, compactando los arreglos.
+// Los choques se buscan sobre todo el tramo recorrido en el paso (detección
+// continua): gana el primer impacto, no el que quede en la posición final.
+//
+// Las balas no son items de la escena: cada una es una instancia en el
+// SpriteBatchItem de su textura (GameWorld::sprites()), que se mueve a la
+// posición simulada en syncVisuals(), una vez por cuadro pintado y no por tick.
+class BulletSystem {
+public:
+    enum class Owner : quint8 { Player = 0, Enemy };
+
+    // Aspecto de la bala: sprite ya escalado, armado una sola vez (ver
+    // kVisualDefs en el .cpp). Disparar no carga ni escala ninguna imagen.
+    enum class Visual : quint8 {
+        Player = 0,     // Bala.png 24x12
+        Enemy,          // bala_enemigo.png 20x10 (soldados, bunker)
+        EnemySmall,     // bala_enemigo.png 16x16 (enemigos top-down)
+        Count
+    };
+
+    // Capacidad fija: las columnas se reservan una vez y no vuelven a crecer;
+    // con el cupo lleno spawn() no crea nada.
+    static constexpr int kCapacity = 4096;
+
+    explicit BulletSystem(GameWorld *world);
+    ~BulletSystem();
+
+    // dir no hace falta que sea unitaria; speed en px/s. Devuelve el índice
+    // (válido hasta el próximo step), o -1 si no hay cupo.
+    int spawn(const QPointF &pos, const QPointF &dir, double speed,
+              Owner owner = Owner::Player, Visual visual = Visual::Player);
+
+    // Arma los sprites de todos los Visual (si no estaban); spawn() también
+    // lo hace la primera vez, esto es para no pagarlo en el primer disparo.
+    void prepareVisuals();
+
+    void step(double dt);
+    void syncVisuals();
+
+    // Reinicio de nivel: olvida las balas (los lotes de sprites los borra la escena)
+    void clear();
+
+    void hashState(StateHash &h) const;
+
+    int count() const { return px_.size(); }
+    int peak() const { return peak_; }         // máximo de balas vivas a la vez
+    int rejected() const { return rejected_; } // disparos perdidos por cupo lleno
+    static const char *kernelName();
+
+private:
+    // Respuesta al chocar con un item de cierta categoría; true = la bala se consume
+    using HitFn = bool (*)(const QPointF &bulletPos, QGraphicsItem *target);
+    static const HitFn kHitTable[2][static_cast<int>(CollisionCategory::Count)];
+    static quint32 hitMask(Owner owner); // categorías con respuesta en la tabla
+
+    struct VisualData {
+        QPixmap pixmap;
+        float halfW = 4.0f, halfH = 4.0f;   // caja de colisión (mitad del sprite)
+        SpriteBatchItem *batch = nullptr;   // lote del nivel actual
+    };
+
+    bool collide(int i, float dt);  // barre el tramo recorrido en el paso
+    void destroy(int i);
+    void move(int from, int to);
+    void resizeAll(int n);
+
+    // --- columnas (mismo índice = misma bala) ---
+    QVector<float> px_, py_;
+    QVector<float> vx_, vy_;
+    QVector<float> life_;
+    QVector<quint8> owner_;
+    QVector<quint8> visual_;
+    QVector<int> instance_;          // handle dentro del lote de su Visual
+
+    VisualData visuals_[static_cast<int>(Visual::Count)];
+    bool visualsReady_ = false;
+
+    GameWorld *world_ = nullptr;
+    quint64 generation_ = 0;    // cambia con clear(): corta un step en curso
+    int peak_ = 0;
+    int rejected_ = 0;
+};
+
+#endif // BULLETSYSTEM_H
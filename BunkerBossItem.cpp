@@ -1,41 +1,19 @@
 #include "BunkerBossItem.h"
 #include "PlayerItem.h"
-#include "Bullet.h"
+#include "BulletSystem.h"
+#include "SpriteCache.h"
+#include "AudioMixer.h"
 #include <QGraphicsScene>
-#include <QTimer>
 #include <QDebug>
 #include <QtMath>
-#include <QSoundEffect>
-#include <QUrl>
-#include <QCoreApplication>
 
 BunkerBossItem::BunkerBossItem(QGraphicsScene *scene, QGraphicsItem *parent)
-    : QObject(), QGraphicsPixmapItem(parent), scene_(scene)
+    : QObject(), QGraphicsPixmapItem(parent), WorldEntity(Phase::Actors), scene_(scene)
 {
-    // --- ¡IMPORTANTE! MODIFICADO ---
-    // Carga los 3 sprites en lugar de uno solo.
-    // ¡¡Asegúrate de que las rutas a tus 3 sprites sean correctas!!
-
-    idlePixmap_ = QPixmap(":/images/images/bunker_quieto.png");     // <--- CAMBIA ESTA RUTA
-    shootPixmap_ = QPixmap(":/images/images/bunker_disparando.png");   // <--- CAMBIA ESTA RUTA
-    destroyedPixmap_ = QPixmap(":/images/images/bunker_destruido.png"); // <--- CAMBIA ESTA RUTA
-
-    // Fallback por si no encuentra el idle
-    if (idlePixmap_.isNull()) {
-        qDebug() << "ERROR: No se encontró el sprite 'bunker_idle.png'.";
-        idlePixmap_ = QPixmap(150, 100);
-        idlePixmap_.fill(Qt::darkGray);
-    }
-
-    // Fallback (opcional) para los otros
-    if (shootPixmap_.isNull()) {
-        qDebug() << "ADVERTENCIA: No se encontró 'bunker_shoot.png', se usará 'idle'.";
-        shootPixmap_ = idlePixmap_;
-    }
-    if (destroyedPixmap_.isNull()) {
-        qDebug() << "ADVERTENCIA: No se encontró 'bunker_destroyed.png', se usará 'idle'.";
-        destroyedPixmap_ = idlePixmap_;
-    }
+    // los tres están en AssetList.h: si faltara uno no compilaría
+    idlePixmap_ = SpriteCache::get(SpriteId::BunkerIdle);
+    shootPixmap_ = SpriteCache::get(SpriteId::BunkerShoot);
+    destroyedPixmap_ = SpriteCache::get(SpriteId::BunkerDestroyed);
 
     // Establecer el sprite inicial
     setPixmap(idlePixmap_);
@@ -45,14 +23,29 @@ BunkerBossItem::BunkerBossItem(QGraphicsScene *scene, QGraphicsItem *parent)
     setOffset(-idlePixmap_.width() / 2, -idlePixmap_.height());
     setZValue(14);
 
-    shootTimer_ = new QTimer(this);
-    // Conectamos el timer de disparo al slot 'onShoot'
-    connect(shootTimer_, &QTimer::timeout, this, &BunkerBossItem::onShoot);
+    // el disparo periódico lo lleva step() (GameWorld)
 }
 
 BunkerBossItem::~BunkerBossItem()
 {
-    if (shootTimer_) shootTimer_->stop();
+}
+
+void BunkerBossItem::hashState(StateHash &h) const
+{
+    h.addInt(health_);
+    h.addInt(active_);
+    h.addReal(shootElapsed_);
+}
+
+void BunkerBossItem::step(double dt)
+{
+    if (!active_ || dying_) return;
+
+    shootElapsed_ += dt;
+    if (shootElapsed_ >= kShootInterval) {
+        shootElapsed_ -= kShootInterval;
+        onShoot();
+    }
 }
 
 void BunkerBossItem::takeDamage(int dmg)
@@ -61,7 +54,8 @@ void BunkerBossItem::takeDamage(int dmg)
 
     health_ -= dmg;
     setOpacity(0.6);
-    QTimer::singleShot(120, this, [this]() { setOpacity(1.0); });
+    GameWorld *world = GameWorld::current();
+    if (world) world->after(0.12, this, [this]() { setOpacity(1.0); });
 
     if (health_ <= 0) {
         health_ = 0;
@@ -78,23 +72,19 @@ void BunkerBossItem::takeDamage(int dmg)
         }
 
         // Sonido de explosión (como lo teníamos)
-        static QSoundEffect* explosionSound_ = nullptr;
-        if (!explosionSound_) {
-            explosionSound_ = new QSoundEffect(qApp);
-            explosionSound_->setSource(QUrl(QStringLiteral("qrc:/sound/sounds/granada.wav")));
-            explosionSound_->setLoopCount(1);
-            explosionSound_->setVolume(1.0f);
-        }
-        explosionSound_->play();
+        AudioMixer::play(SoundId::Explosion);
 
         // Emitimos la señal INMEDIATAMENTE para que GameWindow sepa que ganaste
         emit bunkerDefeated();
 
         // Retrasamos la eliminación 1.5 segundos para que se vea el sprite destruido
-        QTimer::singleShot(1500, this, [this](){ // <--- TIEMPO AUMENTADO
-            if (scene()) scene_->removeItem(this);
-            deleteLater();
-        });
+        if (world) {
+            world->after(1.5, this, [this](){ // <--- TIEMPO AUMENTADO
+                leaveWorld();
+                if (scene()) scene_->removeItem(this);
+                deleteLater();
+            });
+        }
     }
 }
 
@@ -105,14 +95,13 @@ void BunkerBossItem::startAttacking(PlayerItem *player)
     qDebug() << "BunkerBoss: INICIANDO ATAQUE.";
     active_ = true;
     playerTarget_ = player;
-    shootTimer_->start(450);
+    shootElapsed_ = 0.0;
 }
 
 void BunkerBossItem::stopAttacking()
 {
     // ... (Esta función se queda igual)
     active_ = false;
-    if (shootTimer_) shootTimer_->stop();
 }
 
 void BunkerBossItem::onShoot()
@@ -129,7 +118,9 @@ void BunkerBossItem::onShoot()
 
     // --- ¡NUEVO! Programar la vuelta al sprite 'idle' ---
     // (200ms = 0.2 segundos. Ajusta este valor para un "fogonazo" más largo o corto)
-    QTimer::singleShot(200, this, &BunkerBossItem::onShootAnimationFinished);
+    if (GameWorld *world = GameWorld::current()) {
+        world->after(0.2, this, [this]() { onShootAnimationFinished(); });
+    }
 
 
     // --- El resto de la lógica de disparo (se queda igual) ---
@@ -140,16 +131,8 @@ void BunkerBossItem::onShoot()
     if (len > 0.0001) dir /= len;
     else dir = QPointF(-1, 0);
 
-    BulletItem *b = new BulletItem(dir, 450.0, scene_, BulletItem::Owner::Enemy);
-
-    QPixmap enemyBulletPix(":/images/images/bala_enemigo.png");
-    if (!enemyBulletPix.isNull()) {
-        b->setPixmap(enemyBulletPix.scaled(20, 10, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        b->setOffset(-b->pixmap().width()/2, -b->pixmap().height()/2);
-    }
-
-    b->setPos(from);
-    scene_->addItem(b);
+    if (GameWorld *world = GameWorld::current())
+        world->bullets().spawn(from, dir, 450.0, BulletSystem::Owner::Enemy, BulletSystem::Visual::Enemy);
     emit bunkerFired();
 }
 
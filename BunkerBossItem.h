@@ -5,14 +5,18 @@
 #include <QGraphicsPixmapItem>
 #include <QObject>
 #include <QPixmap> // <-- AÑADIR ESTE INCLUDE
+#include "GameWorld.h"
+#include "Collision.h"
 
-class QTimer;
 class QGraphicsScene;
 class PlayerItem;
 
-class BunkerBossItem : public QObject, public QGraphicsPixmapItem {
+class BunkerBossItem : public QObject, public QGraphicsPixmapItem, public WorldEntity {
     Q_OBJECT
 public:
+    enum { Type = BunkerBossItemType };
+    int type() const override { return Type; }
+
     explicit BunkerBossItem(QGraphicsScene *scene, QGraphicsItem *parent = nullptr);
     ~BunkerBossItem() override;
 
@@ -22,6 +26,11 @@ public:
     void startAttacking(PlayerItem *player);
     void stopAttacking();
 
+    // ritmo de disparo; lo llama GameWorld cada tick
+    void step(double dt) override;
+    void hashState(StateHash &h) const override;
+    QGraphicsItem *colliderItem() override { return this; }
+
 signals:
     void bunkerDefeated();
     void bunkerFired();
@@ -33,7 +42,8 @@ private slots:
 private:
     QGraphicsScene *scene_ = nullptr;
     PlayerItem *playerTarget_ = nullptr;
-    QTimer *shootTimer_ = nullptr;
+    double shootElapsed_ = 0.0;
+    static constexpr double kShootInterval = 0.45; // s entre disparos
 
     int health_ = 15;
     bool active_ = false;
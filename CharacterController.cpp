@@ -0,0 +1,106 @@
+#include "CharacterController.h"
+#include "CoverGrid.h"
+#include <QtMath>
+
+namespace {
+// tolerancia para "ya estaba del lado de afuera" (errores de redondeo)
+constexpr double kEps = 1e-6;
+// cuánto sube o baja la caja en un subpaso para seguir pegada a una rampa
+constexpr double kSlopeSnap = 4.0;
+
+// Altura de la rampa en x; false si x cae fuera de ella
+bool slopeY(const QLineF &s, double x, double &y)
+{
+    const double x0 = qMin(s.x1(), s.x2()), x1 = qMax(s.x1(), s.x2());
+    if (x < x0 || x > x1 || qFuzzyCompare(x0, x1)) return false;
+    y = s.y1() + (s.y2() - s.y1()) * (x - s.x1()) / (s.x2() - s.x1());
+    return true;
+}
+
+bool overlapsX(const QRectF &a, const QRectF &b) { return a.right() > b.left() && a.left() < b.right(); }
+bool overlapsY(const QRectF &a, const QRectF &b) { return a.bottom() > b.top() && a.top() < b.bottom(); }
+}
+
+void CharacterController::gather(const CoverGrid *cover, const QRectF &reach)
+{
+    solids_.clear();
+    if (!cover || !cover->overlaps(reach)) return;
+    for (const QRectF &r : cover->rects())
+        if (r.intersects(reach)) solids_.append(r);
+}
+
+CharacterController::Result CharacterController::move(QRectF &box, QPointF &vel, double dt,
+                                                      bool grounded, const PlatformSurfaces &surfaces) const
+{
+    Result res;
+
+    // --- X: las coberturas que comparten franja vertical con la caja ---
+    const double dx = vel.x() * dt;
+    if (!qFuzzyIsNull(dx)) {
+        double t = 1.0;
+        for (const QRectF &w : solids_) {
+            if (!overlapsY(box, w)) continue;
+            if (dx > 0 && box.right() <= w.left() + kEps) t = qMin(t, (w.left() - box.right()) / dx);
+            else if (dx < 0 && box.left() >= w.right() - kEps) t = qMin(t, (w.right() - box.left()) / dx);
+        }
+        t = qMax(0.0, t);
+        box.translate(dx * t, 0);
+        if (t < 1.0) {
+            vel.rx() = 0;
+            res.hitWall = true;
+        }
+    }
+
+    const double feetX = box.center().x();
+
+    // --- apoyada en una rampa: seguirla hacia arriba o hacia abajo ---
+    if (grounded && vel.y() >= 0) {
+        for (const QLineF &s : surfaces.slopes) {
+            double y;
+            if (!slopeY(s, feetX, y) || qAbs(y - box.bottom()) > kSlopeSnap) continue;
+            box.moveBottom(y);
+            vel.ry() = 0;
+            res.onGround = true;
+            return res;
+        }
+    }
+
+    // --- Y: tiempo de impacto contra lo que está debajo o encima ---
+    const double dy = vel.y() * dt;
+    if (dy > 0) {
+        double t = 1.0;
+        // sólo lo que estaba por debajo de los pies al empezar el paso
+        auto land = [&](double top) {
+            if (box.bottom() <= top + kEps) t = qMin(t, (top - box.bottom()) / dy);
+        };
+        for (const QRectF &w : solids_)
+            if (overlapsX(box, w)) land(w.top());
+        for (const QRectF &p : surfaces.oneWay)
+            if (overlapsX(box, p)) land(p.top());
+        for (const QLineF &s : surfaces.slopes) {
+            double y;
+            if (slopeY(s, feetX, y)) land(y);
+        }
+        land(surfaces.floorY);
+
+        t = qMax(0.0, t);
+        box.translate(0, dy * t);
+        if (t < 1.0) {
+            vel.ry() = 0;
+            res.onGround = true;
+        }
+    } else if (dy < 0) {
+        double t = 1.0;
+        for (const QRectF &w : solids_) {
+            if (overlapsX(box, w) && box.top() >= w.bottom() - kEps)
+                t = qMin(t, (w.bottom() - box.top()) / dy);
+        }
+        t = qMax(0.0, t);
+        box.translate(0, dy * t);
+        if (t < 1.0) {
+            vel.ry() = 0;
+            res.hitCeiling = true;
+        }
+    }
+    return res;
+}
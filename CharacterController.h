@@ -0,0 +1,49 @@
+#ifndef CHARACTERCONTROLLER_H
+#define CHARACTERCONTROLLER_H
+
+#pragma once
+#include <QLineF>
+#include <QPointF>
+#include <QRectF>
+#include <QVarLengthArray>
+#include <QVector>
+#include <limits>
+
+class CoverGrid;
+
+// Lo que se pisa en el nivel de plataformas y no es una cobertura. Las
+// coberturas (bunkers...) son sólidas por todos lados y salen de CoverGrid.
+struct PlatformSurfaces {
+    qreal floorY = std::numeric_limits<qreal>::infinity();  // suelo del nivel; infinito = sin suelo
+    QVector<QRectF> oneWay;     // plataformas: sólo sostienen desde arriba, se cruzan desde abajo y de costado
+    QVector<QLineF> slopes;     // rampas: se pisan desde arriba (el orden de los extremos no importa)
+
+    void clear() { *this = PlatformSurfaces(); }
+};
+
+// Controlador cinemático de una caja fija (PlayerItem): la barre contra las
+// coberturas y superficies y la frena en el instante del primer contacto
+// (tiempo de impacto), primero en X y después en Y. No mira sprites ni la
+// escena, así que es barato correrlo varias veces por tick.
+//
+// Uso: gather() una vez por tick con todo lo que la caja puede alcanzar y
+// move() en cada subpaso.
+class CharacterController {
+public:
+    struct Result {
+        bool onGround = false;      // quedó apoyada (suelo, cobertura, plataforma o rampa)
+        bool hitWall = false;
+        bool hitCeiling = false;
+    };
+
+    void gather(const CoverGrid *cover, const QRectF &reach);
+
+    // Mueve 'box' vel*dt; la componente de 'vel' que choca queda en 0.
+    // 'grounded' = venía apoyada: en una rampa se la mantiene pegada.
+    Result move(QRectF &box, QPointF &vel, double dt, bool grounded, const PlatformSurfaces &surfaces) const;
+
+private:
+    QVarLengthArray<QRectF, 16> solids_;
+};
+
+#endif // CHARACTERCONTROLLER_H
@@ -0,0 +1,132 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#pragma once
+#include <QGraphicsItem>
+#include <cmath>
+#include <utility>
+
+// Tipos propios para QGraphicsItem::type(). Cada clase del juego devuelve el
+// suyo: así se sabe qué es un item (y se puede usar qgraphicsitem_cast) sin
+// dynamic_cast ni etiquetas QVariant.
+enum ItemType {
+    PlayerItemType = QGraphicsItem::UserType + 1,
+    TopDownPlayerItemType,
+    EnemyItemType,
+    TopDownEnemyType,
+    BunkerBossItemType,
+    CoverItemType,
+    SpriteBatchItemType,
+    ProjectileItemType,
+    FlamethrowerType
+};
+
+// Categoría de colisión: qué es el item para quien lo golpea. Los proyectiles
+// sólo miran las categorías de su máscara (ver la tabla de BulletSystem).
+enum class CollisionCategory : quint8 {
+    None = 0,
+    Player,         // jugador de plataformas (nivel 1)
+    TopDownPlayer,  // jugador top-down (nivel 2)
+    Soldier,        // EnemyItem
+    RedEnemy,       // TopDownEnemy
+    Bunker,         // BunkerBossItem
+    Cover,          // CoverItem (paredes, bunkers de cobertura)
+    Count
+};
+
+inline CollisionCategory collisionCategory(const QGraphicsItem *item)
+{
+    switch (item->type()) {
+    case PlayerItemType:        return CollisionCategory::Player;
+    case TopDownPlayerItemType: return CollisionCategory::TopDownPlayer;
+    case EnemyItemType:         return CollisionCategory::Soldier;
+    case TopDownEnemyType:      return CollisionCategory::RedEnemy;
+    case BunkerBossItemType:    return CollisionCategory::Bunker;
+    case CoverItemType:         return CollisionCategory::Cover;
+    default:                    return CollisionCategory::None;
+    }
+}
+
+inline quint32 categoryBit(CollisionCategory c)
+{
+    return 1u << static_cast<int>(c);
+}
+
+// Segmento a->b contra un rectángulo (método de las placas). Si lo toca,
+// 'tEnter' es la fracción del segmento (0..1) donde entra; 0 si ya empieza
+// adentro.
+inline bool segmentHitsRect(const QPointF &a, const QPointF &b, const QRectF &r, double *tEnter = nullptr)
+{
+    double t0 = 0.0, t1 = 1.0;
+    const double d[2] = { b.x() - a.x(), b.y() - a.y() };
+    const double p[2] = { a.x(), a.y() };
+    const double lo[2] = { r.left(), r.top() };
+    const double hi[2] = { r.right(), r.bottom() };
+    for (int axis = 0; axis < 2; ++axis) {
+        if (qFuzzyIsNull(d[axis])) {
+            if (p[axis] < lo[axis] || p[axis] > hi[axis]) return false;
+            continue;
+        }
+        double ta = (lo[axis] - p[axis]) / d[axis];
+        double tb = (hi[axis] - p[axis]) / d[axis];
+        if (ta > tb) std::swap(ta, tb);
+        t0 = qMax(t0, ta);
+        t1 = qMin(t1, tb);
+        if (t0 > t1) return false;
+    }
+    if (tEnter) *tEnter = t0;
+    return true;
+}
+
+// Primer instante t en [0, T] en que la parábola p(t) = p0 + v*t + (0, g*t²/2)
+// (una granada) está dentro del rectángulo; false si no llega a tocarlo.
+inline bool parabolaHitsRect(const QPointF &p0, const QPointF &v, double g, double T,
+                             const QRectF &r, double *tHit = nullptr)
+{
+    // tramo de tiempo en que x está dentro (x es lineal)
+    double tx0 = 0.0, tx1 = T;
+    if (qFuzzyIsNull(v.x())) {
+        if (p0.x() < r.left() || p0.x() > r.right()) return false;
+    } else {
+        double ta = (r.left() - p0.x()) / v.x();
+        double tb = (r.right() - p0.x()) / v.x();
+        if (ta > tb) std::swap(ta, tb);
+        tx0 = qMax(tx0, ta);
+        tx1 = qMin(tx1, tb);
+        if (tx0 > tx1) return false;
+    }
+
+    auto y = [&](double t) { return p0.y() + v.y() * t + 0.5 * g * t * t; };
+    auto inside = [&](double t) { const double yt = y(t); return yt >= r.top() && yt <= r.bottom(); };
+    if (inside(tx0)) {
+        if (tHit) *tHit = tx0;
+        return true;
+    }
+
+    // si no empieza adentro, entra cruzando el borde de arriba o el de abajo
+    double best = tx1 + 1.0;
+    for (const double edge : { r.top(), r.bottom() }) {
+        // g/2 t² + vy t + (y0 - edge) = 0
+        const double a = 0.5 * g, b = v.y(), c = p0.y() - edge;
+        double roots[2];
+        int n = 0;
+        if (qFuzzyIsNull(a)) {
+            if (!qFuzzyIsNull(b)) roots[n++] = -c / b;
+        } else {
+            const double disc = b * b - 4.0 * a * c;
+            if (disc >= 0.0) {
+                const double sq = std::sqrt(disc);
+                roots[n++] = (-b - sq) / (2.0 * a);
+                roots[n++] = (-b + sq) / (2.0 * a);
+            }
+        }
+        for (int k = 0; k < n; ++k) {
+            if (roots[k] > tx0 && roots[k] <= tx1 && roots[k] < best) best = roots[k];
+        }
+    }
+    if (best > tx1) return false;
+    if (tHit) *tHit = best;
+    return true;
+}
+
+#endif // COLLISION_H
@@ -0,0 +1,135 @@
+#include "CoverGrid.h"
+#include "Collision.h"
+#include <QtMath>
+#include <cmath>
+#include <limits>
+
+// Bits from..to (inclusive) de una palabra
+static quint64 rangeMask(int from, int to)
+{
+    const quint64 upTo = to >= 63 ? ~0ULL : (1ULL << (to + 1)) - 1;
+    return upTo & (~0ULL << from);
+}
+
+void CoverGrid::setBounds(const QRectF &bounds, qreal cellSize)
+{
+    bounds_ = bounds;
+    cell_ = qMax<qreal>(1.0, cellSize);
+    cols_ = qMax(1, qCeil(bounds.width() / cell_));
+    rows_ = qMax(1, qCeil(bounds.height() / cell_));
+    words_ = (cols_ + 63) / 64;
+    clear();
+}
+
+void CoverGrid::clear()
+{
+    rects_.clear();
+    bits_.fill(0, words_ * rows_);
+}
+
+bool CoverGrid::cellRange(const QRectF &r, int &x0, int &y0, int &x1, int &y1) const
+{
+    x0 = qMax(0, int(std::floor((r.left() - bounds_.left()) / cell_)));
+    y0 = qMax(0, int(std::floor((r.top() - bounds_.top()) / cell_)));
+    x1 = qMin(cols_ - 1, int(std::ceil((r.right() - bounds_.left()) / cell_)) - 1);
+    y1 = qMin(rows_ - 1, int(std::ceil((r.bottom() - bounds_.top()) / cell_)) - 1);
+    return x0 <= x1 && y0 <= y1;
+}
+
+void CoverGrid::addRect(const QRectF &rect)
+{
+    if (rect.isEmpty()) return;
+    rects_.append(rect);
+
+    int x0, y0, x1, y1;
+    if (!cellRange(rect, x0, y0, x1, y1)) return;
+    const int w0 = x0 >> 6, w1 = x1 >> 6;
+    for (int cy = y0; cy <= y1; ++cy) {
+        quint64 *row = bits_.data() + cy * words_;
+        for (int w = w0; w <= w1; ++w)
+            row[w] |= rangeMask(w == w0 ? (x0 & 63) : 0, w == w1 ? (x1 & 63) : 63);
+    }
+}
+
+bool CoverGrid::anyBlocked(int x0, int y0, int x1, int y1) const
+{
+    // una palabra cubre 64 celdas de la fila de una vez
+    const int w0 = x0 >> 6, w1 = x1 >> 6;
+    for (int cy = y0; cy <= y1; ++cy) {
+        const quint64 *row = bits_.constData() + cy * words_;
+        for (int w = w0; w <= w1; ++w) {
+            if (row[w] & rangeMask(w == w0 ? (x0 & 63) : 0, w == w1 ? (x1 & 63) : 63)) return true;
+        }
+    }
+    return false;
+}
+
+int CoverGrid::blockedCells() const
+{
+    int n = 0;
+    for (quint64 w : bits_) n += qPopulationCount(w);
+    return n;
+}
+
+bool CoverGrid::cellBlocked(int cx, int cy) const
+{
+    if (cx < 0 || cy < 0 || cx >= cols_ || cy >= rows_) return false;
+    return (bits_[cy * words_ + (cx >> 6)] >> (cx & 63)) & 1u;
+}
+
+bool CoverGrid::blocked(const QPointF &p) const
+{
+    const int cx = int(std::floor((p.x() - bounds_.left()) / cell_));
+    const int cy = int(std::floor((p.y() - bounds_.top()) / cell_));
+    if (!cellBlocked(cx, cy)) return false;
+    for (const QRectF &r : rects_)
+        if (r.contains(p)) return true;
+    return false;
+}
+
+int CoverGrid::firstOverlap(const QRectF &box) const
+{
+    int x0, y0, x1, y1;
+    if (!cellRange(box, x0, y0, x1, y1) || !anyBlocked(x0, y0, x1, y1)) return -1;
+    for (int i = 0; i < rects_.size(); ++i)
+        if (rects_[i].intersects(box)) return i;
+    return -1;
+}
+
+bool CoverGrid::lineClear(const QPointF &a, const QPointF &b) const
+{
+    if (rects_.isEmpty()) return true;
+
+    // celdas que cruza el segmento, en orden (Amanatides-Woo), hasta la
+    // primera ocupada
+    const double inf = std::numeric_limits<double>::infinity();
+    const double ox = (a.x() - bounds_.left()) / cell_;
+    const double oy = (a.y() - bounds_.top()) / cell_;
+    const double dx = (b.x() - a.x()) / cell_;
+    const double dy = (b.y() - a.y()) / cell_;
+    int cx = int(std::floor(ox));
+    int cy = int(std::floor(oy));
+    const int sx = dx > 0 ? 1 : -1;
+    const int sy = dy > 0 ? 1 : -1;
+    const double deltaX = dx != 0.0 ? 1.0 / std::abs(dx) : inf;
+    const double deltaY = dy != 0.0 ? 1.0 / std::abs(dy) : inf;
+    double tx = dx != 0.0 ? (dx > 0 ? cx + 1 - ox : ox - cx) * deltaX : inf;
+    double ty = dy != 0.0 ? (dy > 0 ? cy + 1 - oy : oy - cy) * deltaY : inf;
+
+    while (!cellBlocked(cx, cy)) {
+        if (tx < ty) {
+            if (tx > 1.0) return true;
+            cx += sx;
+            tx += deltaX;
+        } else {
+            if (ty > 1.0) return true;
+            cy += sy;
+            ty += deltaY;
+        }
+    }
+
+    // llegó a una celda ocupada: lo decide la forma exacta
+    for (const QRectF &r : rects_)
+        if (segmentHitsRect(a, b, r)) return false;
+    return true;
+}
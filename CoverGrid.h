@@ -0,0 +1,56 @@
+#ifndef COVERGRID_H
+#define COVERGRID_H
+
+#pragma once
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+// Coberturas fijas del nivel (CoverItem: paredes, bunkers) horneadas en una
+// rejilla de ocupación de un bit por celda, filas de palabras de 64 bits.
+// GameWorld la arma una sola vez y sólo la rehace si cambian las coberturas;
+// moverse o mirar una línea es leer bits, no preguntarle a la escena.
+//
+// La rejilla es conservadora (una celda tocada por una cobertura queda
+// ocupada): si dice libre es libre, y si dice ocupado se confirma contra los
+// rectángulos, que son pocos. Con las coberturas alineadas a la celda
+// (las del juego lo están, a 10 px) ni siquiera hace falta confirmar.
+class CoverGrid {
+public:
+    void setBounds(const QRectF &bounds, qreal cellSize = 10.0);
+    void clear();                               // sin coberturas, mismos límites
+    void addRect(const QRectF &rect);
+
+    QRectF bounds() const { return bounds_; }
+    qreal cellSize() const { return cell_; }
+    int columns() const { return cols_; }
+    int rows() const { return rows_; }
+    const QVector<QRectF> &rects() const { return rects_; }
+    int blockedCells() const;
+
+    // Fuera de los límites no hay cobertura
+    bool cellBlocked(int cx, int cy) const;
+    bool blocked(const QPointF &p) const;
+
+    // 'box' se superpone (con área) a alguna cobertura
+    bool overlaps(const QRectF &box) const { return firstOverlap(box) >= 0; }
+    int firstOverlap(const QRectF &box) const;  // índice en rects(), -1 si nada
+
+    // Nada tapa el segmento a->b
+    bool lineClear(const QPointF &a, const QPointF &b) const;
+
+private:
+    // celdas que toca 'r' (un borde justo sobre la línea no cuenta); false si cae afuera
+    bool cellRange(const QRectF &r, int &x0, int &y0, int &x1, int &y1) const;
+    bool anyBlocked(int x0, int y0, int x1, int y1) const;
+
+    QRectF bounds_;
+    qreal cell_ = 10.0;
+    int cols_ = 0;
+    int rows_ = 0;
+    int words_ = 0;                             // palabras por fila
+    QVector<quint64> bits_;
+    QVector<QRectF> rects_;
+};
+
+#endif // COVERGRID_H
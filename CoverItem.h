@@ -0,0 +1,18 @@
+#ifndef COVERITEM_H
+#define COVERITEM_H
+
+#pragma once
+#include <QGraphicsRectItem>
+#include "Collision.h"
+
+// Rectángulo de cobertura: frena balas y bloquea el paso (paredes del nivel 2,
+// bunkers delante de los soldados del nivel 1).
+class CoverItem : public QGraphicsRectItem {
+public:
+    enum { Type = CoverItemType };
+    using QGraphicsRectItem::QGraphicsRectItem;
+
+    int type() const override { return Type; }
+};
+
+#endif // COVERITEM_H
@@ -3,31 +3,26 @@
 #include <QGraphicsScene>
 #include <QDebug>
 #include <QPainter>
-#include <QSoundEffect>
-#include <QUrl>
-#include <QCoreApplication>
+#include "SpriteCache.h"
+#include "AudioMixer.h"
 
-EnemyItem::EnemyItem(const QStringList &frames, const QStringList &deathFrames, bool movable, QGraphicsItem *parent)
-    : QObject(), QGraphicsPixmapItem(parent),
+EnemyItem::EnemyItem(const QVector<SpriteId> &frames, const QVector<SpriteId> &deathFrames, bool movable, QGraphicsItem *parent)
+    : QObject(), QGraphicsPixmapItem(parent), WorldEntity(Phase::Actors),
     health_(6),
     movable_(movable),
     dying_(false),
     direction_(1),
-    speed_(1.6),
-    moveTimer_(nullptr),
-    animTimer_(nullptr),
+    speed_(96.0), // 1.6 px por tick a 60 Hz
     currentFrame_(0),
     animIntervalMs_(120),
-    deathTimer_(nullptr),
     currentDeathFrame_(0),
-    deathIntervalMs_(140),
-    deathSound_(nullptr)
+    deathIntervalMs_(140)
 {
     const QSize targetSize(81, 106); // mantener tamaño igual que el player
 
-    // cargar frames de animación normal y death
-    loadFramesFromList(frames, frames_, targetSize);
-    loadFramesFromList(deathFrames, deathFrames_, targetSize);
+    // cargar frames de animación normal y death (ya a targetSize: AssetList.h)
+    loadFramesFromList(frames, frames_);
+    loadFramesFromList(deathFrames, deathFrames_);
 
     // si no hay frames normales crear fallback
     if (frames_.isEmpty()) {
@@ -45,64 +40,25 @@ EnemyItem::EnemyItem(const QStringList &frames, const QStringList &deathFrames,
     applyFramePixmap(frames_.at(0));
     setZValue(15);
 
-    // animación normal
-    if (frames_.size() > 1) {
-        animTimer_ = new QTimer(this);
-        animTimer_->setInterval(animIntervalMs_);
-        connect(animTimer_, &QTimer::timeout, this, &EnemyItem::onAnimTick);
-        animTimer_->start();
-    }
-
-    // movimiento opcional
-    if (movable_) {
-        moveTimer_ = new QTimer(this);
-        connect(moveTimer_, &QTimer::timeout, this, &EnemyItem::onMoveTick);
-        moveTimer_->start(1000/60);
-    }
-
-    // Inicializar sonido de muerte (ajusta la ruta a tu .qrc)
-    if(!deathSound_){
-        deathSound_ = new QSoundEffect(qApp);
-        deathSound_->setSource(QUrl(QStringLiteral("qrc:/sound/sounds/muerte-enemigo.wav")));
-        deathSound_->setLoopCount(1);
-        deathSound_->setVolume(1.0f);
-        //deathSound_->play();
-        //deathSound_->stop();
-    }
+    // animación y movimiento los avanza step() (GameWorld), sin timers propios
 }
 
 EnemyItem::~EnemyItem()
 {
-    if (moveTimer_) moveTimer_->stop();
-    if (animTimer_) animTimer_->stop();
-    if (deathTimer_) deathTimer_->stop();
-    // deathSound_ se libera por parent=this
 }
 
-// helper: cargar QPixmaps desde lista de rutas
-void EnemyItem::loadFramesFromList(const QStringList &paths, QVector<QPixmap> &out, const QSize &targetSize)
+// helper: cargar QPixmaps desde lista de ids
+void EnemyItem::loadFramesFromList(const QVector<SpriteId> &ids, QVector<QPixmap> &out)
 {
     out.clear();
-    for (const QString &p : paths) {
-        QPixmap pix(p);
-        if (pix.isNull()) {
-            qDebug() << "EnemyItem::loadFrames - frame not found:" << p;
-            continue;
-        }
-        QPixmap scaled = pix;
-        if (!targetSize.isEmpty()) {
-            scaled = pix.scaled(targetSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-        }
-        out.append(scaled);
-    }
+    out.reserve(ids.size());
+    // compartido entre los 7 enemigos: se escala una sola vez por proceso
+    for (SpriteId id : ids) out.append(SpriteCache::get(id));
 }
 
-void EnemyItem::setExplosiveDeathFrames(const QStringList &paths)
+void EnemyItem::setExplosiveDeathFrames(const QVector<SpriteId> &frames)
 {
-    explosiveDeathFrames_.clear();
-    // reutilizamos la función helper loadFramesFromList (que escala a targetSize)
-    const QSize targetSize(81, 106);
-    loadFramesFromList(paths, explosiveDeathFrames_, targetSize);
+    loadFramesFromList(frames, explosiveDeathFrames_);
 }
 
 
@@ -115,45 +71,84 @@ void EnemyItem::applyFramePixmap(const QPixmap &pix)
     setOffset(-pixmap().width()/2, -pixmap().height());
 }
 
-// animación normal: cambia frame (ahora con pausa si completa ciclo)
-void EnemyItem::onAnimTick()
+void EnemyItem::hashState(StateHash &h) const
 {
-    if (dying_) return; // no animar normal si está muriendo
-    if (frames_.isEmpty() || !animTimer_) return;
+    h.addPoint(pos());
+    h.addInt(health_);
+    h.addInt(dying_);
+    h.addInt(crouching_);
+    h.addInt(direction_);
+}
 
-    currentFrame_++;
+void EnemyItem::step(double dt)
+{
+    // fin del parpadeo de daño
+    if (flashLeft_ > 0.0) {
+        flashLeft_ -= dt;
+        if (flashLeft_ <= 0.0) setOpacity(1.0);
+    }
 
-    // si todavía hay frame válido, aplicar y salir
-    if (currentFrame_ < frames_.size()) {
-        applyFramePixmap(frames_.at(currentFrame_));
+    if (dying_) {
+        advanceDeath(dt);
         return;
     }
 
-    // llegamos al final del ciclo:
-    // 1) si existe pausePixmap_ mostrarlo; si no, mantener último frame
-    if (!pausePixmap_.isNull()) {
-        applyFramePixmap(pausePixmap_);
+    // agachado: ni anima ni se mueve hasta stopCrouch()
+    if (crouching_) return;
+
+    advanceAnimation(dt);
+    if (movable_) advanceMovement(dt);
+}
+
+// animación normal: cambia frame (ahora con pausa si completa ciclo)
+void EnemyItem::advanceAnimation(double dt)
+{
+    if (frames_.size() <= 1) return;
+
+    // pausa entre ciclos: al terminar volvemos al primer frame
+    if (animPauseLeft_ > 0.0) {
+        animPauseLeft_ -= dt;
+        if (animPauseLeft_ <= 0.0) {
+            animPauseLeft_ = 0.0;
+            animElapsed_ = 0.0;
+            applyFramePixmap(frames_.at(0));
+        }
+        return;
     }
 
-    // 2) parar animTimer_ y programar reanudación tras la pausa
-    animTimer_->stop();
-    currentFrame_ = 0; // reiniciamos contador para el próximo ciclo
+    animElapsed_ += dt;
+    const double interval = animIntervalMs_ / 1000.0;
+    while (animElapsed_ >= interval) {
+        animElapsed_ -= interval;
+        currentFrame_++;
+
+        // si todavía hay frame válido, aplicar y seguir
+        if (currentFrame_ < frames_.size()) {
+            applyFramePixmap(frames_.at(currentFrame_));
+            continue;
+        }
+
+        // llegamos al final del ciclo:
+        // 1) si existe pausePixmap_ mostrarlo; si no, mantener último frame
+        if (!pausePixmap_.isNull()) {
+            applyFramePixmap(pausePixmap_);
+        }
 
-    const int pauseMs = 2000; // duración de la pausa entre ciclos (ajusta)
-    QTimer::singleShot(pauseMs, this, [this]() {
-        if (dying_) return; // si murió durante la pausa, no reiniciamos
-        if (!frames_.isEmpty()) applyFramePixmap(frames_.at(0));
-        if (animTimer_) animTimer_->start(animIntervalMs_);
-    });
+        // 2) pausar y reanudar desde el primer frame cuando pase kCyclePause
+        currentFrame_ = 0; // reiniciamos contador para el próximo ciclo
+        animElapsed_ = 0.0;
+        animPauseLeft_ = kCyclePause;
+        break;
+    }
 }
 
 // movimiento (si movable_)
-void EnemyItem::onMoveTick()
+void EnemyItem::advanceMovement(double dt)
 {
-    if (!scene() || dying_) return;
+    if (!scene()) return;
     QRectF s = scene()->sceneRect();
     QPointF p = pos();
-    p.rx() += direction_ * speed_;
+    p.rx() += direction_ * speed_ * dt;
     setPos(p);
 
     // rebote sencillo en bordes
@@ -167,85 +162,71 @@ void EnemyItem::takeDamage(int dmg, bool explosive)
     if (dying_) return; // ya en death sequence, ignorar
     health_ -= dmg;
 
-    // feedback visual corto parpadeo
+    // feedback visual corto parpadeo (lo apaga step())
     setOpacity(0.6);
-    QTimer::singleShot(120, this, [this]() { setOpacity(1.0); });
+    flashLeft_ = 0.12;
 
     if (health_ > 0) return;
 
     // iniciar animación de muerte
     dying_ = true;
 
-    // reproducir sonido de muerte (si está cargado) — UNA sola vez
-    if (deathSound_) {
-        deathSound_->play();
-    }
-
-    // parar animación y movimiento normales
-    if (animTimer_) { animTimer_->stop(); delete animTimer_; animTimer_ = nullptr; }
-    if (moveTimer_) { moveTimer_->stop(); delete moveTimer_; moveTimer_ = nullptr; }
+    // reproducir sonido de muerte — UNA sola vez
+    AudioMixer::play(SoundId::EnemyDeath);
 
     // Si hay animación de muerte por explosión y se indicó 'explosive' entonces la usamos
-    QVector<QPixmap>* framesToUse = nullptr;
-    int intervalToUse = deathIntervalMs_;
+    dyingFrames_ = nullptr;
+    dyingIntervalMs_ = deathIntervalMs_;
     if (explosive && !explosiveDeathFrames_.isEmpty()) {
-        framesToUse = &explosiveDeathFrames_;
-        intervalToUse = explosiveDeathIntervalMs_;
+        dyingFrames_ = &explosiveDeathFrames_;
+        dyingIntervalMs_ = explosiveDeathIntervalMs_;
     } else if (!deathFrames_.isEmpty()) {
-        framesToUse = &deathFrames_;
-        intervalToUse = deathIntervalMs_;
+        dyingFrames_ = &deathFrames_;
+        dyingIntervalMs_ = deathIntervalMs_;
     }
 
     // si no hay frames (ni normales ni explosivas) esperar a sonido y luego eliminar
-    if (!framesToUse || framesToUse->isEmpty()) {
-        const int waitMs = 1500; // ajusta a la duración real del WAV
-        QTimer::singleShot(waitMs, this, [this]() {
-            emit enemyDefeated(this);
-            if (scene()) scene()->removeItem(this);
-            deleteLater();
-        });
+    if (!dyingFrames_) {
+        deathWaitLeft_ = 1.5; // ajusta a la duración real del WAV
         return;
     }
 
-    // arrancar timer de muerte usando los frames seleccionados
+    // arrancar la animación de muerte con los frames seleccionados
     currentDeathFrame_ = 0;
-    applyFramePixmap(framesToUse->at(0));
+    deathElapsed_ = 0.0;
+    applyFramePixmap(dyingFrames_->at(0));
+}
+
+// avanza la animación de muerte (o la espera si no hay frames)
+void EnemyItem::advanceDeath(double dt)
+{
+    if (deathFinished_) return;
 
-    // si había deathTimer_ antiguo, limpiarlo
-    if (deathTimer_) { deathTimer_->stop(); delete deathTimer_; deathTimer_ = nullptr; }
+    if (!dyingFrames_) {
+        deathWaitLeft_ -= dt;
+        if (deathWaitLeft_ <= 0.0) finishDeath();
+        return;
+    }
 
-    deathTimer_ = new QTimer(this);
-    deathTimer_->setInterval(intervalToUse);
-    // Capturamos 'framesToUse' por puntero; es seguro porque es miembro del objeto
-    connect(deathTimer_, &QTimer::timeout, this, [this, framesToUse]() {
-        if (!framesToUse || framesToUse->isEmpty()) return;
+    deathElapsed_ += dt;
+    const double interval = dyingIntervalMs_ / 1000.0;
+    while (deathElapsed_ >= interval) {
+        deathElapsed_ -= interval;
         currentDeathFrame_++;
-        if (currentDeathFrame_ < framesToUse->size()) {
-            applyFramePixmap(framesToUse->at(currentDeathFrame_));
-            return;
+        if (currentDeathFrame_ < dyingFrames_->size()) {
+            applyFramePixmap(dyingFrames_->at(currentDeathFrame_));
+            continue;
         }
         // terminada la animación de muerte
-        if (deathTimer_) { deathTimer_->stop(); delete deathTimer_; deathTimer_ = nullptr; }
-        emit enemyDefeated(this);
-        if (scene()) scene()->removeItem(this);
-        deleteLater();
-    });
-    deathTimer_->start();
-}
-
-
-// llamado en cada tick de la animación de muerte
-void EnemyItem::onDeathTick()
-{
-    if (deathFrames_.isEmpty()) return;
-    currentDeathFrame_++;
-    if (currentDeathFrame_ < deathFrames_.size()) {
-        applyFramePixmap(deathFrames_.at(currentDeathFrame_));
+        finishDeath();
         return;
     }
+}
 
-    // terminada la animación de muerte
-    if (deathTimer_) { deathTimer_->stop(); delete deathTimer_; deathTimer_ = nullptr; }
+void EnemyItem::finishDeath()
+{
+    deathFinished_ = true;
+    leaveWorld();
 
     // emitir señal y eliminar
     emit enemyDefeated(this);
@@ -261,9 +242,7 @@ void EnemyItem::startCrouch()
     if (dying_ || crouching_) return;
     crouching_ = true;
 
-    // Parar movimiento y animación normal
-    if (moveTimer_) { moveTimer_->stop(); }
-    if (animTimer_) { animTimer_->stop(); }
+    // step() deja de animar y mover mientras crouching_ sea true
 
     if (!pausePixmap_.isNull()) {
         setPixmap(pausePixmap_);
@@ -294,24 +273,9 @@ void EnemyItem::stopCrouch()
         applyFramePixmap(frames_.at(0));
     }
 
-    // Reiniciar animTimer si corresponde
-    if (frames_.size() > 1) {
-        if (!animTimer_) {
-            animTimer_ = new QTimer(this);
-            animTimer_->setInterval(animIntervalMs_);
-            connect(animTimer_, &QTimer::timeout, this, &EnemyItem::onAnimTick);
-        }
-        animTimer_->start();
-    }
-
-    // Reiniciar movimiento si era movable_
-    if (movable_) {
-        if (!moveTimer_) {
-            moveTimer_ = new QTimer(this);
-            connect(moveTimer_, &QTimer::timeout, this, &EnemyItem::onMoveTick);
-        }
-        moveTimer_->start(1000/60);
-    }
+    // Reiniciar el ciclo de animación desde cero (el movimiento sigue solo en step())
+    animElapsed_ = 0.0;
+    animPauseLeft_ = 0.0;
 
     // Restaurar z-value si lo cambiaste en startCrouch
     // setZValue(15);
@@ -4,18 +4,22 @@
 #pragma once
 #include <QGraphicsPixmapItem>
 #include <QObject>
-#include <QTimer>
 #include <QVector>
 #include <QPixmap>
+#include "GameWorld.h"
+#include "Collision.h"
+#include "Assets.h"
 
-class QSoundEffect; // forward declaration
 
-class EnemyItem : public QObject, public QGraphicsPixmapItem {
+class EnemyItem : public QObject, public QGraphicsPixmapItem, public WorldEntity {
     Q_OBJECT
 public:
+    enum { Type = EnemyItemType };
+    int type() const override { return Type; }
+
     // frames = animación normal; deathFrames = animación de muerte
-    explicit EnemyItem(const QStringList &frames = QStringList(),
-                       const QStringList &deathFrames = QStringList(),
+    explicit EnemyItem(const QVector<SpriteId> &frames = QVector<SpriteId>(),
+                       const QVector<SpriteId> &deathFrames = QVector<SpriteId>(),
                        bool movable = false,
                        QGraphicsItem *parent = nullptr);
     ~EnemyItem() override;
@@ -41,17 +45,22 @@ public:
     void setCrouchPixmap(const QPixmap &pix);
 
     // asignar secuencia de animación de muerte por explosión (sprites)
-    void setExplosiveDeathFrames(const QStringList &paths);
+    void setExplosiveDeathFrames(const QVector<SpriteId> &frames);
+
+    // animación, movimiento y muerte; lo llama GameWorld cada tick
+    void step(double dt) override;
+    void hashState(StateHash &h) const override;
+    QGraphicsItem *colliderItem() override { return this; }
 
 signals:
     void enemyDefeated(EnemyItem *enemy);
 
-private slots:
-    void onAnimTick();
-    void onMoveTick();
-    void onDeathTick();
-
 private:
+    void advanceAnimation(double dt);
+    void advanceMovement(double dt);
+    void advanceDeath(double dt);
+    void finishDeath();
+
     // stats / flags
     int health_;
     bool movable_;
@@ -59,20 +68,28 @@ private:
 
     // movimiento
     int direction_;
-    double speed_;
-    QTimer *moveTimer_;
+    double speed_; // px/s
 
-    // animación normal
+    // animación normal (tiempos acumulados en segundos de simulación)
     QVector<QPixmap> frames_;
-    QTimer *animTimer_;
     int currentFrame_;
     int animIntervalMs_;
+    double animElapsed_ = 0.0;
+    double animPauseLeft_ = 0.0;          // > 0 mientras dura la pausa entre ciclos
+    static constexpr double kCyclePause = 2.0; // pausa entre ciclos de animación (s)
 
     // muerte
     QVector<QPixmap> deathFrames_;
-    QTimer *deathTimer_;
     int currentDeathFrame_;
     int deathIntervalMs_;
+    const QVector<QPixmap> *dyingFrames_ = nullptr; // secuencia elegida al morir (normal o explosiva)
+    int dyingIntervalMs_ = 0;
+    double deathElapsed_ = 0.0;
+    double deathWaitLeft_ = 0.0;          // sin frames de muerte: esperar al sonido
+    bool deathFinished_ = false;
+
+    // parpadeo al recibir daño
+    double flashLeft_ = 0.0;
 
     QVector<QPixmap> explosiveDeathFrames_;
     int explosiveDeathIntervalMs_ = 140; // puedes ajustar distinto si quieres
@@ -80,16 +97,13 @@ private:
     // pause-frame (opcional) — si no lo usas, queda vacío
     QPixmap pausePixmap_;
 
-    // sonido de muerte
-    QSoundEffect *deathSound_;
-
     // estado de crouch
     bool crouching_ = false;
 
     // offset dedicado cuando se aplica el sprite de crouch
     QPointF crouchOffset_;
 
-    void loadFramesFromList(const QStringList &paths, QVector<QPixmap> &out, const QSize &targetSize = QSize());
+    void loadFramesFromList(const QVector<SpriteId> &ids, QVector<QPixmap> &out);
     void applyFramePixmap(const QPixmap &pix); // helper para aplicar pixmap y offset
 };
 
@@ -0,0 +1,92 @@
+#include "Flamethrower.h"
+#include "TopDownEnemy.h"
+#include "SpriteCache.h"
+#include <QBrush>
+#include <QPen>
+#include <QtMath>
+
+static_assert(spriteDef(SpriteId::Flame).width == int(Flamethrower::kRange) &&
+              spriteDef(SpriteId::Flame).height == int(Flamethrower::kHalfWidth * 2),
+              "flame.png en AssetList.h tiene que medir lo mismo que el cono");
+
+Flamethrower::Flamethrower(QGraphicsItem *parent)
+    : QGraphicsPolygonItem(parent), WorldEntity(Phase::Projectiles)
+{
+    // El punto (0,0) es el "cañón" del arma; el cono sale hacia la x local
+    // y la rotación lo orienta hacia el -y del jugador.
+    QPolygonF coneShape;
+    coneShape << QPointF(0, 0)
+              << QPointF(kRange, -kHalfWidth)
+              << QPointF(kRange, kHalfWidth);
+    setPolygon(coneShape);
+    setPen(Qt::NoPen);
+
+    // textura al tamaño exacto del cono (una vez, SpriteCache)
+    QPixmap scaled = SpriteCache::get(SpriteId::Flame);
+    if (!scaled.isNull()) {
+        // el brush empieza en el (0,0) del item; el triángulo va de -40 a 40 en Y
+        QBrush flameBrush(scaled);
+        QTransform brushTransform;
+        brushTransform.translate(0, -kHalfWidth);
+        flameBrush.setTransform(brushTransform);
+        setBrush(flameBrush);
+    } else {
+        // Fallback: Color sólido naranja brillante
+        setBrush(QBrush(QColor(255, 69, 0, 200)));
+    }
+
+    setPos(0, -25);
+    setRotation(-90);
+    setZValue(30);
+    setVisible(false);
+}
+
+void Flamethrower::setFiring(bool on)
+{
+    firing_ = on;
+    setVisible(on);
+}
+
+void Flamethrower::hashState(StateHash &h) const
+{
+    h.addInt(firing_);
+}
+
+void Flamethrower::step(double dt)
+{
+    if (!firing_ || !scene()) return;
+
+    GameWorld *world = GameWorld::current();
+    if (!world) return;
+
+    // cono en escena: vértice y eje (unitario)
+    const QPointF origin = mapToScene(QPointF(0, 0));
+    QPointF axis = mapToScene(QPointF(1, 0)) - origin;
+    const qreal axisLen = std::hypot(axis.x(), axis.y());
+    if (axisLen < 1e-6) return;
+    axis /= axisLen;
+
+    SpatialHash::Candidates candidates;
+    world->broadphase().query(sceneBoundingRect(), categoryBit(CollisionCategory::RedEnemy), candidates);
+
+    const double damage = kDamagePerSecond * dt;
+    for (QGraphicsItem *it : candidates) {
+        TopDownEnemy *enemy = static_cast<TopDownEnemy*>(it);
+        if (!enemy->isAlive()) continue;
+
+        // radio del enemigo: mitad del lado corto de su sprite
+        const QRectF br = enemy->boundingRect();
+        const qreal radius = 0.5 * qMin(br.width(), br.height());
+
+        const QPointF d = enemy->scenePos() - origin;
+        const qreal along = d.x() * axis.x() + d.y() * axis.y();
+        if (along < -radius || along > kRange + radius) continue;
+
+        // media anchura del cono a esa distancia, más el radio del enemigo
+        const qreal across = qAbs(d.x() * axis.y() - d.y() * axis.x());
+        const qreal halfWidth = kHalfWidth * qBound<qreal>(0.0, along / kRange, 1.0);
+        if (across > halfWidth + radius) continue;
+
+        enemy->burn(damage);
+    }
+}
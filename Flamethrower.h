@@ -0,0 +1,38 @@
+#ifndef FLAMETHROWER_H
+#define FLAMETHROWER_H
+
+#pragma once
+#include <QGraphicsPolygonItem>
+#include "GameWorld.h"
+#include "Collision.h"
+
+// Lanzallamas del jugador top-down: un solo emisor, hijo de TopDownPlayerItem,
+// que vive todo el nivel. Mientras está encendido, cada tick prueba de forma
+// analítica qué enemigos caen dentro del cono (punto dentro de un triángulo
+// engordado por el radio del enemigo) y les aplica daño proporcional a dt.
+// El dibujo es el mismo cono con la textura en caché; apagado sólo se oculta,
+// así mantener el disparo no crea ni carga nada.
+class Flamethrower : public QGraphicsPolygonItem, public WorldEntity {
+public:
+    enum { Type = FlamethrowerType };
+    int type() const override { return Type; }
+
+    static constexpr qreal kRange = 180.0;       // alcance (px)
+    static constexpr qreal kHalfWidth = 40.0;    // apertura: media anchura en la punta
+    static constexpr double kDamagePerSecond = 36.0;
+
+    // 'parent' es el jugador; el cono apunta hacia su -y local (hacia donde mira)
+    explicit Flamethrower(QGraphicsItem *parent);
+
+    void setFiring(bool on);
+    bool isFiring() const { return firing_; }
+
+    // tras la fase de actores: los enemigos ya se movieron
+    void step(double dt) override;
+    void hashState(StateHash &h) const override;
+
+private:
+    bool firing_ = false;
+};
+
+#endif // FLAMETHROWER_H
@@ -0,0 +1,145 @@
+#include "FlowField.h"
+#include "CoverGrid.h"
+#include <QtMath>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+struct Step { int dx, dy, cost; };
+// las 4 rectas y después las diagonales, cada paso junto a su inverso
+// (el inverso de s es s ^ 1)
+constexpr Step kSteps[8] = {
+    { 1, 0, 10 }, { -1, 0, 10 }, { 0, 1, 10 }, { 0, -1, 10 },
+    { 1, 1, 14 }, { -1, -1, 14 }, { -1, 1, 14 }, { 1, -1, 14 },
+};
+
+// costo sin obstáculos entre dos celdas (octil)
+int octile(int ax, int ay, int bx, int by)
+{
+    const int dx = std::abs(ax - bx), dy = std::abs(ay - by);
+    return 10 * qMax(dx, dy) + 4 * qMin(dx, dy);
+}
+}
+
+void FlowField::build(const CoverGrid &cover, qreal radius)
+{
+    bounds_ = cover.bounds();
+    cell_ = cover.cellSize();
+    radius_ = radius;
+    cols_ = cover.columns();
+    rows_ = cover.rows();
+
+    // una celda es caminable si la caja centrada en ella no toca cobertura
+    walkable_.fill(false, cols_ * rows_);
+    for (int cy = 0; cy < rows_; ++cy) {
+        for (int cx = 0; cx < cols_; ++cx) {
+            const QPointF c = cellCenter(cy * cols_ + cx);
+            walkable_[cy * cols_ + cx] = !cover.overlaps(QRectF(c.x() - radius, c.y() - radius, 2 * radius, 2 * radius));
+        }
+    }
+    dist_.fill(-1, cols_ * rows_);
+    next_.fill(-1, cols_ * rows_);
+    goalCell_ = -1;
+    reachable_ = 0;
+}
+
+int FlowField::cellAt(const QPointF &p) const
+{
+    const int cx = int(std::floor((p.x() - bounds_.left()) / cell_));
+    const int cy = int(std::floor((p.y() - bounds_.top()) / cell_));
+    if (cx < 0 || cy < 0 || cx >= cols_ || cy >= rows_) return -1;
+    return cy * cols_ + cx;
+}
+
+QPointF FlowField::cellCenter(int cell) const
+{
+    return QPointF(bounds_.left() + (cell % cols_ + 0.5) * cell_,
+                   bounds_.top() + (cell / cols_ + 0.5) * cell_);
+}
+
+bool FlowField::update(const QPointF &goal)
+{
+    goal_ = goal;
+    const int start = cellAt(goal);
+    if (start == goalCell_) return false;
+    goalCell_ = start;
+
+    dist_.fill(-1);
+    next_.fill(-1);
+    reachable_ = 0;
+    if (start < 0) return true;
+
+    // Dijkstra desde la meta; next_ apunta de vuelta a la celda que la alcanzó
+    using Node = std::pair<int, int>;   // (costo, celda)
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> open;
+    dist_[start] = 0;
+    open.push({ 0, start });
+    while (!open.empty()) {
+        const Node n = open.top();
+        open.pop();
+        const int c = n.second;
+        if (n.first > dist_[c]) continue;
+        ++reachable_;
+
+        const int cx = c % cols_, cy = c / cols_;
+        for (int s = 0; s < 8; ++s) {
+            const int nx = cx + kSteps[s].dx, ny = cy + kSteps[s].dy;
+            if (nx < 0 || ny < 0 || nx >= cols_ || ny >= rows_) continue;
+            const int nc = ny * cols_ + nx;
+            if (!walkable_[nc]) continue;
+            // diagonal: las dos rectas que la rodean tienen que estar libres
+            if (kSteps[s].dx && kSteps[s].dy &&
+                (!walkable_[cy * cols_ + nx] || !walkable_[ny * cols_ + cx])) continue;
+
+            const int d = n.first + kSteps[s].cost;
+            if (dist_[nc] >= 0 && dist_[nc] <= d) continue;
+            dist_[nc] = d;
+            next_[nc] = qint8(s ^ 1);   // de vuelta hacia 'c'
+            open.push({ d, nc });
+        }
+    }
+    return true;
+}
+
+int FlowField::distance(const QPointF &p) const
+{
+    const int c = cellAt(p);
+    return c < 0 || dist_.isEmpty() ? -1 : dist_[c];
+}
+
+QPointF FlowField::direction(const QPointF &p) const
+{
+    const int c = cellAt(p);
+    if (c < 0 || goalCell_ < 0 || c == goalCell_) return QPointF();
+
+    const int cx = c % cols_, cy = c / cols_;
+    const int gx = goalCell_ % cols_, gy = goalCell_ / cols_;
+    QPointF dir;
+    if (dist_[c] >= 0) {
+        if (dist_[c] == octile(cx, cy, gx, gy)) {
+            // el camino más corto es el de campo abierto: derecho a la meta
+            dir = goal_ - p;
+        } else {
+            const Step &s = kSteps[next_[c]];
+            dir = QPointF(s.dx, s.dy);
+        }
+    } else {
+        // pegado a una cobertura (celda no caminable): ir a la vecina
+        // caminable más cerca de la meta
+        int best = -1;
+        for (int s = 0; s < 8; ++s) {
+            const int nx = cx + kSteps[s].dx, ny = cy + kSteps[s].dy;
+            if (nx < 0 || ny < 0 || nx >= cols_ || ny >= rows_) continue;
+            const int d = dist_[ny * cols_ + nx];
+            if (d >= 0 && (best < 0 || d < dist_[best])) best = ny * cols_ + nx;
+        }
+        if (best < 0) return QPointF();
+        dir = cellCenter(best) - p;
+    }
+
+    const double len = std::hypot(dir.x(), dir.y());
+    return len > 1e-9 ? dir / len : QPointF();
+}
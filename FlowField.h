@@ -0,0 +1,54 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#pragma once
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+class CoverGrid;
+
+// Campo de flujo hacia una meta (el jugador del nivel 2) sobre las celdas de
+// CoverGrid. build() marca por dónde cabe una caja del radio pedido (las
+// coberturas "infladas") y update() corre un Dijkstra desde la celda de la
+// meta: cada celda se queda con la flecha hacia su vecina más cerca de la
+// meta. Los enemigos sólo leen la flecha de su celda, así que el costo no
+// depende de cuántos haya.
+//
+// Costos 10 (recto) y 14 (diagonal); las diagonales no cortan esquinas.
+class FlowField {
+public:
+    void build(const CoverGrid &cover, qreal radius);
+    // Recalcula sólo si la meta cambió de celda (o tras build); true si recalculó
+    bool update(const QPointF &goal);
+
+    bool isEmpty() const { return cols_ == 0; }
+    qreal radius() const { return radius_; }
+    QPointF goal() const { return goal_; }
+    int reachableCells() const { return reachable_; }
+
+    // Hacia dónde caminar desde 'p' (unitario). Si entre p y la meta no hay
+    // nada que rodear, apunta derecho a la meta; nulo si ya está en la celda
+    // de la meta o no hay camino.
+    QPointF direction(const QPointF &p) const;
+    // Costo hasta la meta (10 por celda), -1 si no se llega
+    int distance(const QPointF &p) const;
+
+private:
+    int cellAt(const QPointF &p) const;         // -1 afuera
+    QPointF cellCenter(int cell) const;
+
+    QRectF bounds_;
+    qreal cell_ = 10.0;
+    qreal radius_ = 0.0;
+    int cols_ = 0;
+    int rows_ = 0;
+    QVector<bool> walkable_;
+    QVector<int> dist_;                         // -1 = no se llega
+    QVector<qint8> next_;                       // índice en kSteps, -1 = ninguno
+    QPointF goal_;
+    int goalCell_ = -1;
+    int reachable_ = 0;
+};
+
+#endif // FLOWFIELD_H
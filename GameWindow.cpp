@@ -1,7 +1,9 @@
 #include "GameWindow.h"
 #include "PlayerItem.h"
 #include "Projectile.h"
-#include "Bullet.h"
+#include "BulletSystem.h"
+#include "SpriteCache.h"
+#include "AudioMixer.h"
 
 #include <QGraphicsView>
 #include <QGraphicsScene>
@@ -23,10 +25,13 @@
 
 #include "TopDownPlayerItem.h"
 #include <QMessageBox>
-#include "FlameArea.h"
+#include "GameWorld.h"
+#include "CoverItem.h"
+#include "BroadphaseOverlay.h"
+#include <QElapsedTimer>
 
-GameWindow::GameWindow(int nivel, QWidget *parent)
-    : QMainWindow(parent), nivel_(nivel)
+GameWindow::GameWindow(int nivel, QWidget *parent, bool headless, quint64 seed)
+    : QMainWindow(parent), nivel_(nivel), headless_(headless)
 {
     view_ = new QGraphicsView(this);
     scene_ = new QGraphicsScene(this);
@@ -39,13 +44,21 @@ GameWindow::GameWindow(int nivel, QWidget *parent)
     scene_->setSceneRect(0, 0, 2800, 600);
     view_->setRenderHint(QPainter::Antialiasing);
 
+    // Mundo de simulación: todas las entidades que se creen a partir de aquí
+    // se registran en él y avanzan desde onTick (no tienen timers propios)
+    world_ = new GameWorld(this);
+    world_->setAudioEnabled(!headless_);
+    // todo lo aleatorio de la partida sale de la semilla (ver GameWorld::rng)
+    world_->setSeed(seed ? seed : QRandomGenerator::global()->generate64());
+    world_->makeCurrent();
+    world_->setScene(scene_);
+    world_->bullets().prepareVisuals(); // sprites de bala listos antes del primer disparo
+
     // === Fondo del nivel ===
-    QPixmap bgPixmap(":/images/images/fondo_playa.png");
-    if (bgPixmap.isNull()) {
+    QPixmap scaled = SpriteCache::get(SpriteId::BackgroundBeach);   // al tamaño de la escena
+    if (scaled.isNull()) {
         qDebug() << "GameWindow: background image NOT found!";
     } else {
-        QSize target(scene_->sceneRect().width(), scene_->sceneRect().height());
-        QPixmap scaled = bgPixmap.scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
 
         // aplicamos desplazamiento vertical (hacia arriba)
         QBrush bgBrush(scaled);
@@ -67,11 +80,11 @@ GameWindow::GameWindow(int nivel, QWidget *parent)
     player_ = new PlayerItem();
     player_->setPos(150, 480);
     scene_->addItem(player_);
+    world_->addCollider(player_);
 
     // --- Barra de vida del jugador ---
     healthBar_ = new QLabel(this);
-    healthBar_->setPixmap(QPixmap(":/images/images/vida6.png")
-                              .scaled(200, 90, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    healthBar_->setPixmap(SpriteCache::get(SpriteId::Life6));
     healthBar_->setFixedSize(200, 90);
     healthBar_->move(-10, -10);
     healthBar_->show();
@@ -86,7 +99,7 @@ GameWindow::GameWindow(int nivel, QWidget *parent)
     if (nivel_ == 1) {
         setupLevel1();
         // iniciar musica del nivel 1
-        startLevelMusic();
+        if (!headless_) startLevelMusic();
     }
 
     // HUD: etiqueta de arma (icono + texto)
@@ -109,23 +122,13 @@ GameWindow::GameWindow(int nivel, QWidget *parent)
 
 
     timer_ = new QTimer(this);
+    timer_->setTimerType(Qt::PreciseTimer);
     connect(timer_, &QTimer::timeout, this, &GameWindow::onTick);
-    timer_->start(1000/60);
-
-    // Inicializar sonido reutilizable de disparo enemigo (eficiente)
-    enemyShotSound_ = new QSoundEffect(this);
-    enemyShotSound_->setSource(QUrl(QStringLiteral("qrc:/sound/sounds/arma_enemigo.wav")));
-    enemyShotSound_->setLoopCount(1);
-    enemyShotSound_->setVolume(0.9f);
-    // precarga:
-    //enemyShotSound_->play();
-    //enemyShotSound_->stop();
-
-    // --- NUEVO: SONIDO LANZALLAMAS ---
-    flamethrowerSound_ = new QSoundEffect(this);
-    flamethrowerSound_->setSource(QUrl("qrc:/sound/sounds/lanzallamas.wav"));
-    flamethrowerSound_->setVolume(1.0f);
-    // ---------------------------------
+    startGameClock();
+
+    // Arrancar el mezclador ya: decodifica los efectos en su hilo mientras
+    // se arma el nivel (en headless no se crea: AudioMixer::play() no hace nada)
+    if (!headless_) AudioMixer::instance();
 
     // --- Preparar assets / widgets de Game Over (no mostrarlos aún) ---
     gameOverLabel_ = new QLabel(this);
@@ -162,34 +165,29 @@ GameWindow::GameWindow(int nivel, QWidget *parent)
         );
     retryButton_->hide();
 
-    connect(retryButton_, &QPushButton::clicked, this, &GameWindow::restartLevel);
-
-    // Preparar música/sonido de muerte (ruta: ajusta si hace falta)
-    deathMusic_ = new QSoundEffect(this);
-    deathMusic_->setSource(QUrl(QStringLiteral("qrc:/sound/sounds/derrota.wav")));
-    deathMusic_->setLoopCount(1);
-    deathMusic_->setVolume(1.0f);
-    // no reproducir ahora; se reproducirá tras fade-out de bg music
+    connect(retryButton_, &QPushButton::clicked, this, &GameWindow::onRetryClicked);
 
+    // El nivel 2 no se arma arriba (fondo/suelo/jugador son del nivel 1):
+    // restartLevel() limpia la escena y llama a setupLevel2().
+    if (nivel_ == 2) restartLevel();
 }
 
 GameWindow::~GameWindow()
 {
     if (timer_) timer_->stop();
 
-    // parar y eliminar sonido y animación si existen
-    if (bgFadeAnim_) {
-        bgFadeAnim_->stop();
-        delete bgFadeAnim_;
-        bgFadeAnim_ = nullptr;
-    }
-    if (bgSound_) {
-        bgSound_->stop();
-        delete bgSound_;
-        bgSound_ = nullptr;
+    if (replayMode_ == ReplayMode::Recording) {
+        QString error;
+        if (replay_.save(recordPath_, &error)) {
+            qInfo().noquote() << QString("repetición guardada en %1 (%2 ticks, semilla %3)")
+                                 .arg(recordPath_).arg(replay_.frameCount()).arg(replay_.seed());
+        } else {
+            qWarning().noquote() << QString("no se pudo guardar la repetición %1: %2").arg(recordPath_, error);
+        }
     }
 
-    // enemyShotSound_ se libera por parent=this
+    // parar la música del nivel
+    if (!headless_) stopLevelMusic();
 }
 
 void GameWindow::updateWeaponLabel()
@@ -201,19 +199,19 @@ void GameWindow::updateWeaponLabel()
     if (nivel_ == 2) {
         // En Nivel 2 forzamos el Lanzallamas
         weaponName = "Lanzallamas";
-        weaponIcon = ":/images/images/lanzallamas.png";
+        weaponIcon = QString::fromLatin1(spriteDef(SpriteId::IconFlamethrower).path);
     }
     else {
         // En Nivel 1 sigue la lógica normal (Rifle/Granada)
         switch (currentWeapon) {
         case Weapon::Grenade:
             weaponName = "Granada";
-            weaponIcon = ":/images/images/granade.png";
+            weaponIcon = QString::fromLatin1(spriteDef(SpriteId::IconGrenade).path);
             break;
 
         default:
             weaponName = "Rifle";
-            weaponIcon = ":/images/images/rifle.png";
+            weaponIcon = QString::fromLatin1(spriteDef(SpriteId::IconRifle).path);
             break;
         }
     }
@@ -237,6 +235,9 @@ void GameWindow::setupLevel1()
 {
     // --- CAMBIO: Definir tamaño largo para el nivel de scroll ---
     scene_->setSceneRect(0, 0, 2800, 600);
+    world_->broadphase().setBounds(scene_->sceneRect());
+    // los pies del jugador (la base de su caja) se apoyan en 530: pos().y 480
+    world_->platforms().floorY = 530;
 
     spawnEnemiesForLevel1();
 }
@@ -245,18 +246,14 @@ void GameWindow::setupLevel2()
 {
     // 1. Definimos el tamaño EXACTO de la ventana (1280x650)
     scene_->setSceneRect(0, 0, 1280, 650);
+    world_->broadphase().setBounds(scene_->sceneRect());
 
     // 2. Cargar la imagen
-    QPixmap bgPixmap(":/images/images/fondo_2.png");
-
-    if (!bgPixmap.isNull()) {
-        // 3. La "Magia": Escalar la imagen al tamaño de la escena
-        // Qt::IgnoreAspectRatio -> Estira la imagen para llenar todo (sin bordes negros)
-        // Qt::SmoothTransformation -> Mantiene la calidad para que no se vea pixelada
-        QPixmap scaled = bgPixmap.scaled(scene_->sceneRect().size().toSize(),
-                                         Qt::IgnoreAspectRatio,
-                                         Qt::SmoothTransformation);
+    // 3. La "Magia": Escalar la imagen al tamaño de la escena (una vez; SpriteCache)
+    // Qt::IgnoreAspectRatio -> Estira la imagen para llenar todo (sin bordes negros)
+    QPixmap scaled = SpriteCache::get(SpriteId::BackgroundLevel2);
 
+    if (!scaled.isNull()) {
         // 4. Aplicar como fondo
         scene_->setBackgroundBrush(QBrush(scaled));
     } else {
@@ -269,72 +266,61 @@ void GameWindow::setupLevel2()
     // En el nivel 2 (vista aérea) NO deberías agregarlo, porque el personaje camina sobre el fondo.
     // Asegúrate de NO copiar el bloque del 'ground' aquí.
 
-    // Crear obstaculos (paredes)
-    QGraphicsRectItem *wall1 = new QGraphicsRectItem(0, 0, 20, 150);
+    // Crear obstaculos (paredes): CoverItem retiene balas y bloquea el paso
+    CoverItem *wall1 = new CoverItem(0, 0, 20, 150);
     wall1->setBrush(Qt::NoBrush); // Relleno: NINGUNO (Transparente)
     wall1->setPen(Qt::NoPen);     // Borde: NINGUNO (Invisible)
     wall1->setPos(310, 0);
 
-    wall1->setData(0, "cover");  // <--- Hace que retenga balas
-    // -------------------------------
-
     scene_->addItem(wall1);
+    world_->addCollider(wall1);
 
-    QGraphicsRectItem *wall2 = new QGraphicsRectItem(0, 0, 20, 600);
+    CoverItem *wall2 = new CoverItem(0, 0, 20, 600);
     wall2->setBrush(Qt::NoBrush); // Relleno: NINGUNO (Transparente)
     wall2->setPen(Qt::NoPen);     // Borde: NINGUNO (Invisible)
     wall2->setPos(150, 0);
 
-    wall2->setData(0, "cover");  // <--- Hace que retenga balas
-    // -------------------------------
-
     scene_->addItem(wall2);
+    world_->addCollider(wall2);
 
-    QGraphicsRectItem *wall3 = new QGraphicsRectItem(0, 0, 20, 150);
+    CoverItem *wall3 = new CoverItem(0, 0, 20, 150);
     wall3->setBrush(Qt::NoBrush); // Relleno: NINGUNO (Transparente)
     wall3->setPen(Qt::NoPen);     // Borde: NINGUNO (Invisible)
     wall3->setPos(600, 30);
 
-    wall3->setData(0, "cover");  // <--- Hace que retenga balas
-    // -------------------------------
-
     scene_->addItem(wall3);
+    world_->addCollider(wall3);
 
-    QGraphicsRectItem *wall4 = new QGraphicsRectItem(0, 0, 20, 150);
+    CoverItem *wall4 = new CoverItem(0, 0, 20, 150);
     wall4->setBrush(Qt::NoBrush); // Relleno: NINGUNO (Transparente)
     wall4->setPen(Qt::NoPen);     // Borde: NINGUNO (Invisible)
     wall4->setPos(770, 400);
 
-    wall4->setData(0, "cover");  // <--- Hace que retenga balas
-    // -------------------------------
-
     scene_->addItem(wall4);
+    world_->addCollider(wall4);
 
-    QGraphicsRectItem *wall5 = new QGraphicsRectItem(0, 0, 20, 150);
+    CoverItem *wall5 = new CoverItem(0, 0, 20, 150);
     wall5->setBrush(Qt::NoBrush); // Relleno: NINGUNO (Transparente)
     wall5->setPen(Qt::NoPen);     // Borde: NINGUNO (Invisible)
     wall5->setPos(910, 400);
 
-    wall5->setData(0, "cover");  // <--- Hace que retenga balas
-    // -------------------------------
-
     scene_->addItem(wall5);
+    world_->addCollider(wall5);
 
-    QGraphicsRectItem *wall6 = new QGraphicsRectItem(0, 0, 20, 150);
+    CoverItem *wall6 = new CoverItem(0, 0, 20, 150);
     wall6->setBrush(Qt::NoBrush); // Relleno: NINGUNO (Transparente)
     wall6->setPen(Qt::NoPen);     // Borde: NINGUNO (Invisible)
     wall6->setPos(530, 400);
 
-    wall6->setData(0, "cover");  // <--- Hace que retenga balas
-    // -------------------------------
-
     scene_->addItem(wall6);
+    world_->addCollider(wall6);
 
     // Crear jugador top-down
     tdPlayer_ = new TopDownPlayerItem();
     // Centrarlo de inicio
     tdPlayer_->setPos(250, 40);
     scene_->addItem(tdPlayer_);
+    world_->addCollider(tdPlayer_);
 
     // Conexiones...
     connect(tdPlayer_, &TopDownPlayerItem::playerHealthChanged, this, &GameWindow::updateHealthBar);
@@ -349,14 +335,14 @@ void GameWindow::setupLevel2()
     messageLabel_->move((width() - messageLabel_->width())/2, 50); // Centrado arriba
     messageLabel_->show();
 
-    // 2. Resetear variables
+    // 2. Resetear variables (y tener listos sprites/sonidos de los enemigos)
     survivalEnemies_.clear();
+    survivalSpawnQueue_.clear();
+    TopDownEnemy::preload();
     survivalSecondsLeft_ = 50;
 
-    // 3. Crear Timer de 1 segundo para la cuenta regresiva
-    survivalTimer_ = new QTimer(this);
-    connect(survivalTimer_, &QTimer::timeout, this, &GameWindow::updateSurvivalTimer);
-    survivalTimer_->start(1000); // Cada 1 segundo
+    // 3. Cuenta regresiva: un "tick" por segundo de simulación (reloj del mundo)
+    scheduleSurvivalTick();
 
     // 4. Generar la primera oleada (4 enemigos)
     spawnSurvivalWave();
@@ -368,18 +354,18 @@ void GameWindow::setupLevel2()
 void GameWindow::spawnEnemiesForLevel1()
 {
     // Secuencia de animación normal
-    QStringList enemyFrames = {
-        ":/images/images/enemigo1.png",
-        ":/images/images/enemigo2.png",
-        ":/images/images/enemigo3.png",
-        ":/images/images/enemigo4.png"
+    const QVector<SpriteId> enemyFrames = {
+        SpriteId::EnemyWalk1,
+        SpriteId::EnemyWalk2,
+        SpriteId::EnemyWalk3,
+        SpriteId::EnemyWalk4
     };
 
     // Secuencia de animación de muerte
-    QStringList deathFrames = {
-        ":/images/images/muerte_enemigo1.png",
-        ":/images/images/muerte_enemigo2.png",
-        ":/images/images/muerte_enemigo3.png"
+    const QVector<SpriteId> deathFrames = {
+        SpriteId::EnemyDeath1,
+        SpriteId::EnemyDeath2,
+        SpriteId::EnemyDeath3
     };
 
     int count = 7;
@@ -394,11 +380,11 @@ void GameWindow::spawnEnemiesForLevel1()
         // Guardar en la lista de enemigos para la secuencia
         enemies_.append(e);
 
-        QStringList explosiveDeath = {
-            ":/images/images/explosion_enemigo1.png",
-            ":/images/images/explosion_enemigo2.png",
-            ":/images/images/explosion_enemigo3.png",
-            ":/images/images/muerte_enemigo3.png"
+        const QVector<SpriteId> explosiveDeath = {
+            SpriteId::EnemyBlast1,
+            SpriteId::EnemyBlast2,
+            SpriteId::EnemyBlast3,
+            SpriteId::EnemyDeath3
         };
         e->setExplosiveDeathFrames(explosiveDeath);
 
@@ -437,20 +423,16 @@ void GameWindow::spawnEnemiesForLevel1()
 
 
         // --- Crear bunker delante del enemigo ---
-        QGraphicsRectItem *bunker = new QGraphicsRectItem(0, 0, 40, 60);
+        CoverItem *bunker = new CoverItem(0, 0, 40, 60);
         bunker->setBrush(QBrush(QColor(100, 100, 100))); // color gris bunker
         bunker->setPen(QPen(Qt::black));
         bunker->setPos(e->pos().x() - 60, 480 - 20); // justo delante del enemigo
         bunker->setZValue(3); // detrás del jugador, pero delante del enemigo
-        bunker->setData(0, QStringLiteral("cover"));
-        bunker->setData(1, bunker->rect().height()); // altura útil del bunker
         scene_->addItem(bunker);
+        world_->addCollider(bunker);
 
         // Si tienes sprite específico para agachado, asignarlo:
-        QPixmap crouchPix(":/images/images/enemigo_agachado.png");
-        if (!crouchPix.isNull()) {
-            e->setCrouchPixmap(crouchPix);
-        }
+        e->setCrouchPixmap(SpriteCache::get(SpriteId::EnemyCrouch));
     }
 
     // -----------------------------
@@ -461,16 +443,17 @@ void GameWindow::spawnEnemiesForLevel1()
             if (!e || !e->isAlive()) continue;
 
             // Probabilidad de agacharse (1 de cada 3)
-            if ((QRandomGenerator::global()->bounded(2) == 0) && !e->isCrouching()) {
+            if ((world_->rng(RngStream::AI).bounded(2) == 0) && !e->isCrouching()) {
                 e->startCrouch();
                 // Se levantan después de 800 ms (ajusta si quieres)
-                QTimer::singleShot(800, e, &EnemyItem::stopCrouch);
+                world_->after(0.8, e, [e]() { e->stopCrouch(); });
             }
         }
     });
 
     // iniciar secuencia de disparo de enemigos (tras un pequeño delay para que todo esté listo)
-    QTimer::singleShot(800, this, [this]() {
+    // (todo el secuenciador usa el reloj del mundo: corre igual en headless)
+    world_->after(0.8, this, [this]() {
         beginEnemyShootingSequence();
     });
 
@@ -490,7 +473,7 @@ void GameWindow::spawnEnemiesForLevel1()
 
     connect(bunkerBoss_, &BunkerBossItem::bunkerFired, this, [this]() {
         // Reutilizamos el sonido de disparo de enemigo que ya tenías
-        if (enemyShotSound_) enemyShotSound_->play();
+        AudioMixer::play(SoundId::EnemyShot, 0.9f);
     });
 }
 
@@ -518,45 +501,18 @@ void GameWindow::keyPressEvent(QKeyEvent *event)
 {
     if (event->isAutoRepeat()) return;
 
-    // --- Nivel 2: control top-down ---
-    if (nivel_ == 2 && tdPlayer_) {
-        // WASD / flechas para mover; espacio para disparar
-        if (event->key() == Qt::Key_A || event->key() == Qt::Key_Left) {
-            // FIX: no acceder a members privados de TopDownPlayerItem; usar valor literal o getter.
-            tdPlayer_->setMoveX(-260.0);
-            return;
-        } else if (event->key() == Qt::Key_D || event->key() == Qt::Key_Right) {
-            tdPlayer_->setMoveX(260.0);
-            return;
-        } else if (event->key() == Qt::Key_W || event->key() == Qt::Key_Up) {
-            tdPlayer_->setMoveY(-260.0);
-            return;
-        } else if (event->key() == Qt::Key_S || event->key() == Qt::Key_Down) {
-            tdPlayer_->setMoveY(260.0);
-            return;
-        } else if (event->key() == Qt::Key_Space) {
-            isShooting_ = true; // <--- ¡Aquí está el cambio clave!
-            return;
-        }
+    // F3: rejilla de la broadphase (depuración, no es entrada de juego)
+    if (event->key() == Qt::Key_F3) {
+        setBroadphaseOverlayVisible(!showBroadphase_);
+        return;
     }
 
-    // --- Nivel 1 / input global ---
-    if (gameOver_) return; // no aceptar input tras morir
-
-    if (event->key() == Qt::Key_Left || event->key() == Qt::Key_A) {
-        moveLeftPressed = true;
-    } else if (event->key() == Qt::Key_Right || event->key() == Qt::Key_D) {
-        moveRightPressed = true;
-    } else if (event->key() == Qt::Key_W) {
-        // SALTAR
-        if (player_) player_->jump();
-    } else if (event->key() == Qt::Key_Space) {
-        fireCurrentWeapon();
-    } else if (event->key() == Qt::Key_Q) {
-        currentWeapon = (currentWeapon == Weapon::Grenade) ? Weapon::Gun : Weapon::Grenade;
-        updateWeaponLabel();
-    } else if (event->key() == Qt::Key_S) {
-        if (player_) player_->startCrouch();
+    // Sólo se anota el botón: se aplica al empezar el siguiente tick (applyInput)
+    const quint8 b = buttonForKey(event->key());
+    if (b && replayMode_ != ReplayMode::Playing) {
+        heldInput_ |= b;
+        pressedLatch_ |= b;
+        return;
     }
 
     QMainWindow::keyPressEvent(event);
@@ -568,40 +524,72 @@ void GameWindow::keyReleaseEvent(QKeyEvent *event)
 {
     if (event->isAutoRepeat()) return;
 
-    // Nivel 2: parar movimiento por eje
-    if (nivel_ == 2 && tdPlayer_) {
-        if (event->key() == Qt::Key_A || event->key() == Qt::Key_Left) {
-            tdPlayer_->stopX();
-            return;
-        } else if (event->key() == Qt::Key_D || event->key() == Qt::Key_Right) {
-            tdPlayer_->stopX();
-            return;
-        } else if (event->key() == Qt::Key_W || event->key() == Qt::Key_Up) {
-            tdPlayer_->stopY();
-            return;
-        } else if (event->key() == Qt::Key_S || event->key() == Qt::Key_Down) {
-            tdPlayer_->stopY();
-            return;
-        }
-        // DETENER DISPARO (Lanzallamas)
-        else if (event->key() == Qt::Key_Space) {
-            isShooting_ = false; // <--- Apagamos la bandera
+    const quint8 b = buttonForKey(event->key());
+    if (b && replayMode_ != ReplayMode::Playing) {
+        heldInput_ &= ~b;
+        return;
+    }
+    QMainWindow::keyReleaseEvent(event);
+}
 
+quint8 GameWindow::buttonForKey(int key) const
+{
+    switch (key) {
+    case Qt::Key_A: case Qt::Key_Left:  return BtnLeft;
+    case Qt::Key_D: case Qt::Key_Right: return BtnRight;
+    case Qt::Key_W:                     return BtnUp;
+    case Qt::Key_Up:                    return nivel_ == 2 ? BtnUp : 0;   // en el nivel 1 sólo W salta
+    case Qt::Key_S:                     return BtnDown;
+    case Qt::Key_Down:                  return nivel_ == 2 ? BtnDown : 0; // en el nivel 1 sólo S agacha
+    case Qt::Key_Space:                 return BtnFire;
+    case Qt::Key_Q:                     return BtnSwitch;
+    default:                            return 0;
+    }
+}
+
+void GameWindow::applyInput(const InputFrame &in)
+{
+    const quint8 held = in.held;
+    const quint8 pressed = in.pressed;
+    // soltado en este tick (incluye los toques que empezaron y terminaron entre dos ticks)
+    const quint8 released = (prevHeld_ | pressed) & ~held;
+    prevHeld_ = held;
+
+    // --- Nivel 2: control top-down ---
+    if (nivel_ == 2 && tdPlayer_) {
+        // WASD / flechas para mover (si se aprietan los dos sentidos, se anulan)
+        const double speed = 260.0;
+        double vx = 0.0, vy = 0.0;
+        if (held & BtnLeft)  vx -= speed;
+        if (held & BtnRight) vx += speed;
+        if (held & BtnUp)    vy -= speed;
+        if (held & BtnDown)  vy += speed;
+        tdPlayer_->setMoveX(vx);
+        tdPlayer_->setMoveY(vy);
+
+        // espacio = lanzallamas mientras se mantenga (un toque corto dispara una vez)
+        const bool shooting = ((held | pressed) & BtnFire) != 0;
+        if (isShooting_ && !shooting) {
             // Importante: ¡Callar el sonido inmediatamente!
-            if (flamethrowerSound_) flamethrowerSound_->stop();
-            return;
+            AudioMixer::stop(SoundId::Flamethrower);
         }
+        isShooting_ = shooting;
+        return;
     }
 
-    // Nivel 1 / global
-    if (event->key() == Qt::Key_Left || event->key() == Qt::Key_A) {
-        moveLeftPressed = false;
-    } else if (event->key() == Qt::Key_Right || event->key() == Qt::Key_D) {
-        moveRightPressed = false;
-    } else if (event->key() == Qt::Key_S) {
-        if (player_) player_->stopCrouch();
+    // --- Nivel 1 ---
+    moveLeftPressed = (held & BtnLeft) != 0;
+    moveRightPressed = (held & BtnRight) != 0;
+
+    if (!player_) return;
+    if (pressed & BtnUp) player_->jump();       // SALTAR
+    if (pressed & BtnFire) fireCurrentWeapon();
+    if (pressed & BtnSwitch) {
+        currentWeapon = (currentWeapon == Weapon::Grenade) ? Weapon::Gun : Weapon::Grenade;
+        updateWeaponLabel();
     }
-    QMainWindow::keyReleaseEvent(event);
+    if (pressed & BtnDown) player_->startCrouch();
+    if (released & BtnDown) player_->stopCrouch();
 }
 
 
@@ -619,9 +607,8 @@ void GameWindow::fireCurrentWeapon()
         bool facingLeft = player_->isFacingLeft();
         QPointF start = player_->pos() + QPointF(facingLeft ? -0 : 0, -20); // <-- más separada DEL PLAYER
         qDebug() << "Launching grenade at" << start << "facingLeft=" << facingLeft;
-        ProjectileItem *p = new ProjectileItem(v0, angle * (facingLeft ? -1.0 : 1.0), scene_);
-        p->setPos(start);
-        scene_->addItem(p);
+        // reciclada del pool de granadas; si están todas en el aire, no sale
+        if (!ProjectileItem::launch(start, v0, angle * (facingLeft ? -1.0 : 1.0), scene_)) return;
 
         // Notificar a los listeners (enemigos) que el jugador disparó
         if (player_) player_->notifyFired();
@@ -642,25 +629,230 @@ void GameWindow::fireCurrentWeapon()
         start += QPointF(facingLeft ? -10 : 10, -32);  // bala alta
 
 
-    BulletItem *b = new BulletItem(dir, 500.0, scene_, BulletItem::Owner::Player);
-    b->setPos(start);
-    scene_->addItem(b);
+    world_->bullets().spawn(start, dir, 500.0, BulletSystem::Owner::Player);
 
     // Notificar a los listeners (enemigos) que el jugador disparó
     if (player_) player_->notifyFired();
 }
 
 
+void GameWindow::startGameClock()
+{
+    accumulator_ = 0.0;
+    frameClock_.start();
+    // en headless no hay timer: runHeadless() llama a stepSimulation() en bucle
+    if (timer_ && !headless_) timer_->start(1000/60);
+}
+
+int GameWindow::runHeadless(double simSeconds)
+{
+    // reproduciendo: se corre la repetición completa, no 'simSeconds'
+    const qint64 maxTicks = (replayMode_ == ReplayMode::Playing)
+                                ? replay_.frameCount()
+                                : static_cast<qint64>(simSeconds / kFixedDt);
+    const int startLevel = nivel_;
+
+    QElapsedTimer wall;
+    wall.start();
+
+    qint64 ticks = 0;
+    while (ticks < maxTicks && !headlessDone_) {
+        if (gameOver_) {
+            // en la repetición el jugador pulsó "Reintentar" aquí
+            if (!replayWantsRestart()) break;
+            restartLevel();
+        }
+
+        advanceTick();
+        ++ticks;
+
+        if (pendingNextLevel_) {
+            pendingNextLevel_ = false;
+            loadNextLevel();
+        }
+
+        // balas/enemigos muertos usan deleteLater(): vaciarlos de vez en cuando,
+        // ya que aquí no corre el event loop
+        if ((ticks % 60) == 0) {
+            QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        }
+    }
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    if (replayMode_ == ReplayMode::Playing) finishReplay(); // cortada antes de tiempo
+
+    const double wallMs = wall.nsecsElapsed() / 1e6;
+    const double simS = ticks * kFixedDt;
+    const double speedup = wallMs > 0.0 ? (simS * 1000.0) / wallMs : 0.0;
+
+    QString reason = QStringLiteral("tiempo");
+    if (headlessDone_) reason = QStringLiteral("victoria");
+    else if (gameOver_) reason = QStringLiteral("game over");
+
+    qInfo().noquote() << QString("headless: nivel %1->%2, %3 ticks (%4 s de juego) en %5 ms, x%6 tiempo real")
+                         .arg(startLevel).arg(nivel_).arg(ticks)
+                         .arg(simS, 0, 'f', 1).arg(wallMs, 0, 'f', 1).arg(speedup, 0, 'f', 1);
+    qInfo().noquote() << QString("headless: fin por %1; entidades vivas %2, enemigos nivel 1: %3, oleadas: %4, enemigos en oleada: %5")
+                         .arg(reason).arg(world_->entityCount()).arg(enemies_.size())
+                         .arg(survivalWavesSpawned_).arg(survivalEnemies_.size());
+    qInfo().noquote() << QString("headless: broadphase %1 pares candidatos en total (%2 por tick)")
+                         .arg(world_->broadphase().stats().totalCandidates)
+                         .arg(ticks > 0 ? double(world_->broadphase().stats().totalCandidates) / ticks : 0.0, 0, 'f', 1);
+    qInfo().noquote() << QString("headless: balas vivas %1 (pico %2), núcleo %3")
+                         .arg(world_->bullets().count()).arg(world_->bullets().peak())
+                         .arg(QString::fromLatin1(BulletSystem::kernelName()));
+    qInfo().noquote() << QString("headless: pools granadas %1/%2 (máx %3), explosiones %4/%5 (máx %6), balas máx %7 de %8")
+                         .arg(ProjectileItem::pool().allocated()).arg(ProjectileItem::pool().capacity())
+                         .arg(ProjectileItem::pool().highWater())
+                         .arg(ProjectileItem::explosionPool().allocated()).arg(ProjectileItem::explosionPool().capacity())
+                         .arg(ProjectileItem::explosionPool().highWater())
+                         .arg(world_->bullets().peak()).arg(BulletSystem::kCapacity);
+    const SpriteCache::Stats sprites = SpriteCache::stats();
+    qInfo().noquote() << QString("headless: sprites %1 en caché (%2 KiB), aciertos %3% de %4 pedidos")
+                         .arg(sprites.entries).arg(sprites.bytes / 1024)
+                         .arg(sprites.hitRate() * 100.0, 0, 'f', 1).arg(sprites.hits + sprites.misses);
+    return divergedAt_ >= 0 ? 1 : 0;
+}
+
+void GameWindow::startRecording(const QString &path)
+{
+    recordPath_ = path;
+    replay_.begin(nivel_, world_->seed(), qRound(1.0 / kFixedDt));
+    replayMode_ = ReplayMode::Recording;
+}
+
+void GameWindow::startReplay(const Replay &replay)
+{
+    if (replay.level() != nivel_ || replay.seed() != world_->seed()) {
+        qWarning() << "repetición de otro nivel/semilla: se ignora";
+        return;
+    }
+    replay_ = replay;
+    replayTick_ = 0;
+    divergedAt_ = -1;
+    heldInput_ = pressedLatch_ = 0;
+    replayMode_ = ReplayMode::Playing;
+    if (replay_.frameCount() == 0) finishReplay();
+}
+
+bool GameWindow::replayWantsRestart() const
+{
+    return replayMode_ == ReplayMode::Playing
+           && replayTick_ < replay_.frameCount()
+           && (replay_.frame(replayTick_).pressed & BtnRestart);
+}
+
+void GameWindow::finishReplay()
+{
+    replayMode_ = ReplayMode::Off;
+    if (divergedAt_ < 0) {
+        qInfo().noquote() << QString("repetición terminada: %1 ticks, sin divergencias").arg(replayTick_);
+    } else {
+        qWarning().noquote() << QString("repetición terminada: %1 ticks, DIVERGE desde el tick %2")
+                                .arg(replayTick_).arg(divergedAt_);
+    }
+}
+
+void GameWindow::onRetryClicked()
+{
+    if (replayMode_ == ReplayMode::Playing) return; // lo decide la repetición
+    restartLevel();
+    // queda registrado como entrada del siguiente tick
+    pressedLatch_ |= BtnRestart;
+}
+
+void GameWindow::advanceTick()
+{
+    // 1. Entrada de este tick: de la repetición o del teclado
+    InputFrame in;
+    if (replayMode_ == ReplayMode::Playing) {
+        in = replay_.frame(replayTick_);
+    } else {
+        in.held = heldInput_;
+        in.pressed = pressedLatch_;
+        pressedLatch_ = 0;
+    }
+
+    applyInput(in);
+    stepSimulation(kFixedDt);
+
+    // 2. Grabar / comparar la huella del estado resultante
+    if (replayMode_ == ReplayMode::Off) return;
+
+    const quint32 hash = Replay::foldHash(stateHash());
+    if (replayMode_ == ReplayMode::Recording) {
+        replay_.record(in, hash);
+        return;
+    }
+
+    if (divergedAt_ < 0 && hash != replay_.hash(replayTick_)) {
+        divergedAt_ = replayTick_;
+        qWarning().noquote() << QString("repetición: el estado diverge en el tick %1 (esperado %2, obtenido %3)")
+                                .arg(replayTick_)
+                                .arg(replay_.hash(replayTick_), 8, 16, QChar('0'))
+                                .arg(hash, 8, 16, QChar('0'));
+    }
+    if (++replayTick_ >= replay_.frameCount()) finishReplay();
+}
+
+quint64 GameWindow::stateHash() const
+{
+    StateHash h;
+    h.addInt(nivel_);
+    h.addInt(gameOver_);
+    h.addInt(survivalSecondsLeft_);
+    h.addInt(survivalSpawnQueue_.size());
+    h.addInt(currentShooterIndex);
+    h.addInt(currentWeapon == Weapon::Grenade);
+    if (player_) {
+        h.addPoint(player_->pos());
+        h.addInt(player_->getLives());
+        h.addInt(player_->isCrouching());
+    }
+    if (tdPlayer_) {
+        h.addPoint(tdPlayer_->pos());
+        h.addInt(tdPlayer_->getLives());
+    }
+    world_->hashState(h);
+    return h.value();
+}
+
 void GameWindow::onTick()
 {
     if (gameOver_) return;
 
-    double dt = 1.0/60.0;
+    // Tiempo real transcurrido desde el frame anterior (alta resolución)
+    double frameTime = frameClock_.nsecsElapsed() / 1e9;
+    frameClock_.restart();
+    if (frameTime > kMaxFrameTime) frameTime = kMaxFrameTime;
+
+    accumulator_ += frameTime;
+
+    // Consumir el tiempo acumulado en pasos fijos
+    int steps = 0;
+    while (accumulator_ >= kFixedDt && steps < kMaxCatchUpSteps) {
+        advanceTick();
+        accumulator_ -= kFixedDt;
+        ++steps;
 
+        // un paso puede terminar el juego (muerte, nivel completado...)
+        if (gameOver_) return;
+    }
+
+    // Si no alcanzamos a ponernos al día, descartamos el resto en vez de
+    // arrastrarlo al siguiente frame (la simulación se ralentiza, pero no explota)
+    if (steps == kMaxCatchUpSteps && accumulator_ >= kFixedDt) {
+        accumulator_ = 0.0;
+    }
+
+    updateCamera();
+}
+
+void GameWindow::stepSimulation(double dt)
+{
     // --- Nivel 1 (Plataformas) ---
     if (nivel_ == 1) {
-        if (moveLeftPressed && player_) player_->moveLeft();
-        if (moveRightPressed && player_) player_->moveRight();
+        if (moveLeftPressed && player_) player_->moveLeft(dt);
+        if (moveRightPressed && player_) player_->moveRight(dt);
         if (player_) player_->updateFrame(dt);
     }
 
@@ -670,30 +862,85 @@ void GameWindow::onTick()
         // 1. ¡ESTA ES LA LÍNEA QUE FALTABA! (Mueve al jugador)
         tdPlayer_->updateFrame(dt);
 
-        // 2. Mover a los enemigos (También faltaba esto)
-        for (TopDownEnemy* e : survivalEnemies_) {
-            if (e && e->isAlive()) {
-                e->updateBehavior(dt);
-            }
-        }
+        // 2. Enemigos de la oleada que faltan aparecer (con tope por tick);
+        //    los que ya están los mueve world_->step() (abajo)
+        drainSpawnQueue();
 
-        // 3. Lógica del Lanzallamas
+        // 3. Lanzallamas: el emisor del jugador hace el daño en world_->step()
+        tdPlayer_->setFiring(isShooting_);
         if (fireCooldown_ > 0) fireCooldown_--;
 
         if (isShooting_ && fireCooldown_ <= 0) {
-
-            FlameArea* flame = new FlameArea(QPointF(0, -1), scene_, tdPlayer_);
-            flame->setPos(0, -25);
-
-            if (flamethrowerSound_ && !flamethrowerSound_->isPlaying()) {
-                flamethrowerSound_->play();
-            }
+            // una sola voz: si ya suena, el mezclador lo ignora
+            AudioMixer::play(SoundId::Flamethrower);
 
             tdPlayer_->notifyFired();
             fireCooldown_ = 5;
         }
     }
 
+    // --- Un solo pase para todas las entidades, en orden fijo ---
+    // (actores -> proyectiles -> efectos; ver WorldEntity::Phase)
+    world_->step(dt);
+}
+
+void GameWindow::setBroadphaseOverlayVisible(bool on)
+{
+    showBroadphase_ = on;
+    if (on && !broadphaseOverlay_) {
+        broadphaseOverlay_ = new BroadphaseOverlay(world_);
+        scene_->addItem(broadphaseOverlay_);
+    } else if (!on && broadphaseOverlay_) {
+        scene_->removeItem(broadphaseOverlay_);
+        delete broadphaseOverlay_;
+        broadphaseOverlay_ = nullptr;
+    }
+
+    if (!broadphaseLabel_) {
+        broadphaseLabel_ = new QLabel(this);
+        broadphaseLabel_->setStyleSheet("color: #FFD27F; background: rgba(0,0,0,150); padding: 4px; font-family: monospace;");
+        broadphaseLabel_->move(10, height() - 40);
+    }
+    broadphaseLabel_->setVisible(on);
+    updateBroadphaseDebug();
+}
+
+void GameWindow::updateBroadphaseDebug()
+{
+    if (!showBroadphase_ || !broadphaseLabel_) return;
+
+    const SpatialHash::Stats &st = world_->broadphase().stats();
+    broadphaseLabel_->setText(QString("broadphase: %1 colliders | %2 celdas ocupadas (máx %3) | "
+                                      "%4 consultas | %5 pares candidatos/tick")
+                                  .arg(st.colliders).arg(st.occupiedCells).arg(st.maxPerCell)
+                                  .arg(st.queries).arg(st.candidates)
+                              + QString("\nsprites: %1 en caché (%2 KiB), aciertos %3%")
+                                  .arg(SpriteCache::stats().entries).arg(SpriteCache::stats().bytes / 1024)
+                                  .arg(SpriteCache::stats().hitRate() * 100.0, 0, 'f', 1));
+    if (!headless_) {
+        const AudioMixer::Stats au = AudioMixer::instance()->stats();
+        broadphaseLabel_->setText(broadphaseLabel_->text()
+                                  + QString("\naudio: %1/%2 voces | %3 robadas | %4 descartadas%5")
+                                        .arg(au.activeVoices).arg(AudioMixer::kVoices)
+                                        .arg(au.stolen).arg(au.dropped)
+                                        .arg(au.running ? "" : " (sin salida)")
+                                  + QString(" | música: %1 cortes | banco %2 KiB%3")
+                                        .arg(au.musicUnderruns).arg(au.bankBytes / 1024)
+                                        .arg(au.bankMapped ? " mapeado" : ""));
+    }
+    broadphaseLabel_->adjustSize();
+    if (broadphaseOverlay_) broadphaseOverlay_->update();
+}
+
+void GameWindow::updateCamera()
+{
+    if (headless_) return; // nadie mira la vista
+
+    // las balas se simulan por tick pero sus sprites sólo se mueven al pintar
+    world_->bullets().syncVisuals();
+    world_->sprites().flush();
+    updateBroadphaseDebug();
+
     // --- Lógica de Cámara ---
     if (nivel_ == 2) {
         // Cámara Fija
@@ -719,66 +966,20 @@ void GameWindow::onTick()
 
 void GameWindow::startLevelMusic()
 {
-    // ya existe y está sonando => no hacemos nada
-    if (bgSound_ && bgSound_->isPlaying()) return;
-
-    if (!bgSound_) {
-        bgSound_ = new QSoundEffect(this);
-
-        // ruta en resources (ajusta si tu qrc usa otro prefix)
-        bgSound_->setSource(QUrl(QStringLiteral("qrc:/sound/sounds/ambiente_playa.wav")));
-
-        // loop infinito
-        bgSound_->setLoopCount(QSoundEffect::Infinite);
-
-        // precarga silenciosa para evitar latencia (play+stop con volumen 0)
-        bgSound_->setVolume(0.0f);
-        bgSound_->play();
-        bgSound_->stop();
-    }
-
-    // iniciar reproducción y hacer fade-in
-    bgSound_->setLoopCount(QSoundEffect::Infinite);
-    bgSound_->play();
-
-    // fade-in del volumen (0.0 -> 0.45 en 800 ms)
-    if (bgFadeAnim_) {
-        bgFadeAnim_->stop();
-        delete bgFadeAnim_;
-        bgFadeAnim_ = nullptr;
-    }
-    bgFadeAnim_ = new QPropertyAnimation(bgSound_, "volume", this);
-    bgFadeAnim_->setDuration(800);
-    bgFadeAnim_->setStartValue(0.0);
-    bgFadeAnim_->setEndValue(0.6);
-    bgFadeAnim_->start(QAbstractAnimation::DeleteWhenStopped);
+    // en streaming: arranca al instante (sin precarga) y entra con un fundido
+    // cruzado desde lo que sonara antes (el tema del menú)
+    levelMusic_ = true;
+    AudioMixer::playMusic(MusicTrack::Beach, 0.6f, 800);
 }
 
 void GameWindow::fadeOutAndStopLevelMusic(int ms)
 {
-    if (!bgSound_) return;
-
-    QPropertyAnimation *anim = new QPropertyAnimation(bgSound_, "volume", this);
-    anim->setDuration(ms);
-    anim->setStartValue(bgSound_->volume());
-    anim->setEndValue(0.0);
-    connect(anim, &QPropertyAnimation::finished, this, [this, anim]() {
-        if (bgSound_) bgSound_->stop();
-        anim->deleteLater();
-    });
-    anim->start(QAbstractAnimation::DeleteWhenStopped);
+    AudioMixer::stopMusic(ms);
 }
 
 void GameWindow::stopLevelMusic()
 {
-    if (bgFadeAnim_) {
-        bgFadeAnim_->stop();
-        delete bgFadeAnim_;
-        bgFadeAnim_ = nullptr;
-    }
-    if (bgSound_) {
-        bgSound_->stop();
-    }
+    AudioMixer::stopMusic();
 }
 
 // ------------------------
@@ -823,7 +1024,7 @@ void GameWindow::shootCycleForEnemy()
     if (!shooter || !shooter->isAlive()) {
         // avanzar índice y reintentar pronto
         if (!enemies_.isEmpty()) currentShooterIndex = (currentShooterIndex + 1) % enemies_.size();
-        QTimer::singleShot(150, this, [this]() { this->shootCycleForEnemy(); });
+        world_->after(0.15, this, [this]() { this->shootCycleForEnemy(); });
         return;
     }
 
@@ -834,7 +1035,7 @@ void GameWindow::shootCycleForEnemy()
     // Programar los disparos (usar QPointer para evitar use-after-free)
     for (int i = 0; i < shots; ++i) {
         QPointer<EnemyItem> shooterPtr = shooter;
-        QTimer::singleShot(i * intervalMs, this, [this, shooterPtr]() {
+        world_->after(i * intervalMs / 1000.0, this, [this, shooterPtr]() {
             // COMPROBACIONES AL INICIO: si la secuencia fue desactivada o game over -> salir
             if (!enemyShootingActive_ || gameOver_) return;
             if (!shooterPtr) return;
@@ -848,40 +1049,31 @@ void GameWindow::shootCycleForEnemy()
             if (len > 0.0001) dir /= len;
             else dir = QPointF(-1, 0);
 
-            BulletItem *b = new BulletItem(dir, 420.0, scene_, BulletItem::Owner::Enemy);
-
-            QPixmap enemyBulletPix(":/images/images/bala_enemigo.png");
-            if (!enemyBulletPix.isNull()) {
-                b->setPixmap(enemyBulletPix.scaled(20, 10, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-                b->setOffset(-b->pixmap().width()/2, -b->pixmap().height()/2);
-            }
-
             QPointF spawnOffset = QPointF(dir.x()*36, dir.y()*8);
-            b->setPos(from + spawnOffset);
-            if (scene_) scene_->addItem(b);
+            world_->bullets().spawn(from + spawnOffset, dir, 420.0, BulletSystem::Owner::Enemy, BulletSystem::Visual::Enemy);
 
-            if (enemyShotSound_) enemyShotSound_->play();
+            AudioMixer::play(SoundId::EnemyShot, 0.9f);
         });
     }
 
     // Después de todos los disparos, el enemigo se agacha y esperamos hideMs antes de siguiente
     int totalShotsMs = shots * intervalMs;
     QPointer<EnemyItem> shooterPtr2 = shooter;
-    QTimer::singleShot(totalShotsMs + 60, this, [this, shooterPtr2]() {
+    world_->after((totalShotsMs + 60) / 1000.0, this, [this, shooterPtr2]() {
         // Si la secuencia fue desactivada o el enemigo ya fue destruido, avanzamos al siguiente
         if (!enemyShootingActive_ || gameOver_) return;
 
         if (!shooterPtr2) {
             if (!enemies_.isEmpty()) {
                 currentShooterIndex = (currentShooterIndex + 1) % enemies_.size();
-                QTimer::singleShot(150, this, [this]() { this->shootCycleForEnemy(); });
+                world_->after(0.15, this, [this]() { this->shootCycleForEnemy(); });
             }
             return;
         }
         if (!shooterPtr2->isAlive()) {
             if (!enemies_.isEmpty()) {
                 currentShooterIndex = (currentShooterIndex + 1) % enemies_.size();
-                QTimer::singleShot(150, this, [this]() { this->shootCycleForEnemy(); });
+                world_->after(0.15, this, [this]() { this->shootCycleForEnemy(); });
             }
             return;
         }
@@ -890,12 +1082,12 @@ void GameWindow::shootCycleForEnemy()
 
         const int hideMs = 3000;
         QPointer<EnemyItem> shooterPtr3 = shooterPtr2;
-        QTimer::singleShot(hideMs, this, [this, shooterPtr3]() {
+        world_->after(hideMs / 1000.0, this, [this, shooterPtr3]() {
             if (!enemyShootingActive_ || gameOver_) return;
             if (shooterPtr3 && shooterPtr3->isAlive()) shooterPtr3->stopCrouch();
             if (!enemies_.isEmpty()) {
                 currentShooterIndex = (currentShooterIndex + 1) % enemies_.size();
-                QTimer::singleShot(200, this, [this]() { this->shootCycleForEnemy(); });
+                world_->after(0.2, this, [this]() { this->shootCycleForEnemy(); });
             }
         });
     });
@@ -907,14 +1099,9 @@ void GameWindow::updateHealthBar(int lives)
 {
     if (!healthBar_) return;
 
-    QString spritePath = QString(":/images/images/vida%1.png").arg(lives);
-    QPixmap pix(spritePath);
-    if (pix.isNull()) {
-        qWarning() << "⚠️ Sprite de vida no encontrado:" << spritePath;
-        return;
-    }
-
-    healthBar_->setPixmap(pix.scaled(200, 90, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    // vida1..vida6 van seguidas en AssetList.h
+    if (lives < 1 || lives > 6) return;
+    healthBar_->setPixmap(SpriteCache::get(static_cast<SpriteId>(int(SpriteId::Life1) + lives - 1)));
 }
 
 void GameWindow::showGameOver()
@@ -927,11 +1114,8 @@ void GameWindow::showGameOver()
     stopEnemyShootingSequence();
 
     if (timer_ && timer_->isActive()) timer_->stop();
-    fadeOutAndStopLevelMusic(800);
-
-    QTimer::singleShot(900, this, [this]() {
-        if (deathMusic_) deathMusic_->play();
-    });
+    // la música del nivel se funde con la de derrota (suena una vez)
+    AudioMixer::playMusic(MusicTrack::Defeat, 1.0f, 800, false);
 
     if (gameOverLabel_) {
         int w = gameOverLabel_->width();
@@ -952,6 +1136,13 @@ void GameWindow::showGameOver()
     }
 
     if (player_) player_->setEnabled(false);
+
+    // repetición en ventana: el tick se detuvo; si aquí se pulsó "Reintentar", repetirlo
+    if (replayWantsRestart() && !headless_) {
+        QTimer::singleShot(1500, this, [this]() {
+            if (gameOver_ && replayWantsRestart()) restartLevel();
+        });
+    }
 }
 
 
@@ -973,11 +1164,11 @@ void GameWindow::restartLevel()
     }
 
     // 2) Parar música/sonidos/timers
-    if (deathMusic_ && deathMusic_->isPlaying()) deathMusic_->stop();
-    if (bgSound_ && bgSound_->isPlaying()) bgSound_->stop();
+    stopLevelMusic();
     if (timer_ && timer_->isActive()) timer_->stop();
 
-    // 3) Limpiar escena
+    // 3) Soltar entidades y temporizadores del mundo, luego limpiar escena
+    if (world_) world_->clear();
     if (scene_) {
         QList<QGraphicsItem*> items = scene_->items();
         for (QGraphicsItem *it : items) {
@@ -986,7 +1177,9 @@ void GameWindow::restartLevel()
         }
     }
 
-    // 4) Limpiar punteros
+    // 4) Limpiar punteros (y lo apretado antes de reiniciar)
+    pressedLatch_ = 0;
+    broadphaseOverlay_ = nullptr; // se borró con la escena; se vuelve a crear abajo
     enemies_.clear();
     tdPlayer_ = nullptr;
     player_ = nullptr;
@@ -1007,10 +1200,8 @@ void GameWindow::restartLevel()
         // --- CONFIGURACIÓN NIVEL 1 (Plataforma) ---
 
         // Fondo Nivel 1
-        QPixmap bgPixmap(":/images/images/fondo_playa.png");
-        if (!bgPixmap.isNull()) {
-            QSize target(2800, 600);
-            QPixmap scaled = bgPixmap.scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        QPixmap scaled = SpriteCache::get(SpriteId::BackgroundBeach);
+        if (!scaled.isNull()) {
             QBrush bgBrush(scaled);
             QTransform transform;
             transform.translate(0, -80);
@@ -1028,6 +1219,7 @@ void GameWindow::restartLevel()
         player_ = new PlayerItem();
         player_->setPos(150, 480);
         scene_->addItem(player_);
+        world_->addCollider(player_);
 
         // Conexiones Nivel 1
         connect(player_, &PlayerItem::playerHealthChanged, this, [this](int lives) {
@@ -1050,15 +1242,14 @@ void GameWindow::restartLevel()
 
     updateWeaponLabel();
 
-    if (bgSound_) {
-        bgSound_->setVolume(0.6f);
-        bgSound_->play();
-    }
+    if (levelMusic_) AudioMixer::playMusic(MusicTrack::Beach, 0.6f);
 
     enemyShootingActive_ = true;
 
-    // 10) Reiniciar el timer principal
-    if (timer_) timer_->start(1000/60);
+    if (showBroadphase_) setBroadphaseOverlayVisible(true);
+
+    // 10) Reiniciar el timer principal (y el reloj, para no "recuperar" el tiempo en pausa)
+    startGameClock();
 
     qDebug() << "✅ Nivel reiniciado correctamente";
 }
@@ -1071,9 +1262,18 @@ void GameWindow::checkLevelCompletion()
     if (enemies_.isEmpty() && bunkerBoss_ && !bunkerBoss_->isAlive()) {
 
         qDebug() << "¡¡¡NIVEL COMPLETADO!!!";
+
         gameOver_ = true; // Evita que el jugador se mueva
         if (timer_) timer_->stop();
 
+        // headless: sin pantalla de victoria ni espera; el cambio de nivel lo hace
+        // runHeadless() al terminar el paso (aquí aún estamos dentro de un step()
+        // del búnker/bala, no se puede limpiar la escena todavía)
+        if (headless_) {
+            pendingNextLevel_ = true;
+            return;
+        }
+
         fadeOutAndStopLevelMusic(800);
 
         // --- Pantalla de Victoria ---
@@ -1122,52 +1322,78 @@ void GameWindow::spawnSurvivalWave()
 
     // Cantidad de enemigos por oleada (puedes ajustarlo)
     int enemyCount = 10;
+    ++survivalWavesSpawned_;
 
+    // Sólo se sortean las posiciones; los enemigos se construyen de a poco
+    // en drainSpawnQueue() para que el cambio de oleada no trabe un frame.
     for (int i = 0; i < enemyCount; i++) {
-        // Crear enemigo
-        TopDownEnemy* enemy = new TopDownEnemy(tdPlayer_, scene_);
-
         // Posición aleatoria a la DERECHA (entre X=1100 y X=1250)
-        int randX = 1100 + QRandomGenerator::global()->bounded(150);
+        int randX = 1100 + world_->rng(RngStream::Spawn).bounded(150);
         // Altura aleatoria (dentro de los 650 de alto)
-        int randY = QRandomGenerator::global()->bounded(50, 600);
-
-        enemy->setPos(randX, randY);
-        scene_->addItem(enemy);
-        survivalEnemies_.append(enemy);
-
-        // Detectar muerte
-        connect(enemy, &TopDownEnemy::enemyDied, this, [this, enemy](){
-
-            // Verificar si el enemigo está en la lista (para no procesarlo dos veces)
-            if (survivalEnemies_.contains(enemy)) {
-
-                // 1. Lo sacamos de la lista de enemigos "activos" (lógica del juego)
-                survivalEnemies_.removeAll(enemy);
+        int randY = world_->rng(RngStream::Spawn).bounded(50, 600);
+        survivalSpawnQueue_.append(QPointF(randX, randY));
+    }
+}
 
-                // -------------------------------------------------------------
-                // 2. ¡AQUÍ ESTABA EL ERROR!
-                // scene_->removeItem(enemy);  <--- COMENTADA / BORRADA
-                // -------------------------------------------------------------
-                // Al quitar esta línea, dejamos que el objeto siga existiendo visualmente
-                // para que pueda mostrar su sprite de muerto. Él mismo se borrará
-                // con el 'deleteLater' que pusimos en su función takeDamage.
+void GameWindow::drainSpawnQueue()
+{
+    if (survivalSpawnQueue_.isEmpty() || gameOver_) return;
+
+    // el tope de tiempo depende de la máquina: fuera de él cuando hay que reproducir
+    const bool timeBudget = !headless_ && replayMode_ == ReplayMode::Off;
+    QElapsedTimer clock;
+    clock.start();
+
+    int built = 0;
+    while (!survivalSpawnQueue_.isEmpty() && built < kMaxSpawnsPerTick) {
+        if (built > 0 && timeBudget && clock.nsecsElapsed() > qint64(spawnBudgetMs_ * 1e6)) break;
+        spawnSurvivalEnemy(survivalSpawnQueue_.takeFirst());
+        ++built;
+    }
+}
 
-                // 3. Si se acabaron los enemigos de esta lista, lanzar nueva oleada
-                if (survivalEnemies_.isEmpty()) {
-                    spawnSurvivalWave();
-                }
+void GameWindow::spawnSurvivalEnemy(const QPointF &pos)
+{
+    // Crear enemigo (sprites y sonidos del prototipo compartido)
+    TopDownEnemy* enemy = new TopDownEnemy(tdPlayer_, scene_);
+    enemy->setPos(pos);
+    scene_->addItem(enemy);
+    survivalEnemies_.append(enemy);
+
+    // Detectar muerte
+    connect(enemy, &TopDownEnemy::enemyDied, this, [this, enemy](){
+
+        // Verificar si el enemigo está en la lista (para no procesarlo dos veces)
+        if (survivalEnemies_.contains(enemy)) {
+
+            // 1. Lo sacamos de la lista de enemigos "activos" (lógica del juego)
+            survivalEnemies_.removeAll(enemy);
+
+            // -------------------------------------------------------------
+            // 2. ¡AQUÍ ESTABA EL ERROR!
+            // scene_->removeItem(enemy);  <--- COMENTADA / BORRADA
+            // -------------------------------------------------------------
+            // Al quitar esta línea, dejamos que el objeto siga existiendo visualmente
+            // para que pueda mostrar su sprite de muerto. Él mismo se borrará
+            // con el 'deleteLater' que pusimos en su función takeDamage.
+
+            // 3. Si se acabaron los enemigos de esta oleada (también los que
+            // faltaban aparecer), lanzar nueva oleada
+            if (survivalEnemies_.isEmpty() && survivalSpawnQueue_.isEmpty()) {
+                spawnSurvivalWave();
             }
-        });
-    }
+        }
+    });
+}
+
+void GameWindow::scheduleSurvivalTick()
+{
+    world_->after(1.0, this, [this]() { updateSurvivalTimer(); });
 }
 
 void GameWindow::updateSurvivalTimer()
 {
-    if (gameOver_) {
-        survivalTimer_->stop();
-        return;
-    }
+    if (gameOver_) return; // la cuenta se detiene (no se reprograma)
 
     survivalSecondsLeft_--;
     messageLabel_->setText(QString("¡AGUANTA LAS OLEADAS! Tiempo: %1").arg(survivalSecondsLeft_));
@@ -1175,16 +1401,22 @@ void GameWindow::updateSurvivalTimer()
 
     // GANASTE
     if (survivalSecondsLeft_ <= 0) {
-        survivalTimer_->stop();
         messageLabel_->hide();
 
         // Matar enemigos restantes visualmente (opcional)
         for(auto e : survivalEnemies_) if(e) delete e;
         survivalEnemies_.clear();
+        survivalSpawnQueue_.clear();
 
         // Mostrar Victoria y pasar de nivel (o terminar)
         // Reutilizamos tu logica de victoria
         gameOver_ = true;
+
+        if (headless_) {
+            headlessDone_ = true;
+            return;
+        }
+
         QLabel *victory = new QLabel("¡SOBREVIVISTE!", this);
         victory->setStyleSheet("color: lime; font-size: 40px; background: rgba(0,0,0,180); padding: 20px; border-radius: 10px;");
         victory->adjustSize();
@@ -1198,5 +1430,8 @@ void GameWindow::updateSurvivalTimer()
             QMessageBox::information(this, "Fin", "Juego Completado");
             close();
         });
+        return;
     }
+
+    scheduleSurvivalTick();
 }
@@ -4,12 +4,12 @@
 #pragma once
 #include <QMainWindow>
 #include <QLabel>
-#include <QSoundEffect>
-#include <QPropertyAnimation>
 #include <QGraphicsPixmapItem>
 #include <QVector>
 #include <QPushButton>
+#include <QElapsedTimer>
 #include "TopDownEnemy.h"
+#include "Replay.h"
 
 class QGraphicsView;
 class QGraphicsScene;
@@ -18,15 +18,33 @@ class QTimer;
 class EnemyItem;
 class BunkerBossItem;
 class TopDownPlayerItem;
+class GameWorld;
+class BroadphaseOverlay;
 
 enum class Weapon { Grenade, Gun };
 
 class GameWindow : public QMainWindow {
     Q_OBJECT
 public:
-    explicit GameWindow(int nivel = 1, QWidget *parent = nullptr);
+    // headless = sin ventana ni audio; la simulación la conduce runHeadless()
+    // seed = semilla de la partida (0 = una al azar)
+    explicit GameWindow(int nivel = 1, QWidget *parent = nullptr, bool headless = false,
+                        quint64 seed = 0);
     ~GameWindow() override;
 
+    // Grabar la entrada de cada tick (y el hash del estado) en 'path'.
+    // Llamar justo después del constructor; se guarda al destruir la ventana.
+    void startRecording(const QString &path);
+
+    // Reproducir una repetición: la ventana debe haberse creado con el nivel y
+    // la semilla de la repetición. El teclado se ignora hasta que termine.
+    void startReplay(const Replay &replay);
+
+    // Corre el nivel actual a máxima velocidad (sin esperar al reloj real)
+    // durante 'simSeconds' segundos de juego o hasta Game Over. Imprime un
+    // resumen (ticks, tiempo real, aceleración) y devuelve el código de salida.
+    int runHeadless(double simSeconds);
+
 protected:
     void keyPressEvent(QKeyEvent *event) override;
     void keyReleaseEvent(QKeyEvent *event) override;
@@ -40,14 +58,65 @@ private slots:
 
     void checkLevelCompletion();
 
+    void onRetryClicked();
+
+public:
+    // Tiempo real máximo por tick para construir enemigos de una oleada
+    void setSpawnBudgetMs(double ms) { spawnBudgetMs_ = qMax(0.0, ms); }
+
 private:
     int nivel_;
+    bool headless_ = false;
+    bool headlessDone_ = false;        // headless: el juego terminó (victoria final)
+    bool pendingNextLevel_ = false;    // headless: nivel completado, cambiar tras el paso
     QGraphicsView *view_;
     QGraphicsScene *scene_;
     QGraphicsPixmapItem *bgItem_ = nullptr; // <-- fondo
     PlayerItem *player_;
     TopDownPlayerItem *tdPlayer_ = nullptr;
     QTimer *timer_;
+
+    // --- Reloj de juego (paso fijo) ---
+    // La simulación avanza siempre en pasos de kFixedDt, sin importar cuándo
+    // dispare timer_: medimos el tiempo real con frameClock_ y lo acumulamos.
+    static constexpr double kFixedDt = 1.0 / 60.0;
+    static constexpr int kMaxCatchUpSteps = 5;     // máximo de pasos por frame (evita "espiral de la muerte")
+    static constexpr double kMaxFrameTime = 0.25;  // un frame más largo que esto se recorta (ventana arrastrada, breakpoint...)
+    QElapsedTimer frameClock_;
+    double accumulator_ = 0.0;
+    GameWorld *world_ = nullptr;       // balas, granadas, enemigos y efectos (un solo pase por tick)
+    void startGameClock();             // (re)arranca timer_ y el reloj sin arrastrar tiempo viejo
+    void stepSimulation(double dt);    // un paso fijo de lógica
+    void advanceTick();                // entrada del tick + stepSimulation + grabar/verificar
+
+    // --- Entrada por tick ---
+    // El teclado sólo marca botones; se aplican al empezar cada tick, igual
+    // en vivo que al reproducir una repetición.
+    quint8 heldInput_ = 0;             // botones apretados ahora
+    quint8 pressedLatch_ = 0;          // apretados desde el último tick
+    quint8 prevHeld_ = 0;              // 'held' del tick anterior
+    quint8 buttonForKey(int key) const;
+    void applyInput(const InputFrame &in);
+
+    // --- Grabación / repetición ---
+    enum class ReplayMode { Off, Recording, Playing };
+    ReplayMode replayMode_ = ReplayMode::Off;
+    Replay replay_;
+    QString recordPath_;
+    int replayTick_ = 0;               // siguiente tick de la repetición
+    int divergedAt_ = -1;              // primer tick con hash distinto (-1 = ninguno)
+    quint64 stateHash() const;
+    bool replayWantsRestart() const;   // el siguiente tick grabado empieza con "Reintentar"
+    void finishReplay();
+    void updateCamera();               // una vez por frame, tras los pasos
+
+    // --- Depuración de la broadphase (F3) ---
+    bool showBroadphase_ = false;
+    BroadphaseOverlay *broadphaseOverlay_ = nullptr;
+    QLabel *broadphaseLabel_ = nullptr;
+    void setBroadphaseOverlayVisible(bool on);
+    void updateBroadphaseDebug();      // contadores + repintar la rejilla
+
     bool moveLeftPressed = false;
     bool moveRightPressed = false;
 
@@ -67,9 +136,8 @@ private:
     // NEW: disparar según arma
     void fireCurrentWeapon();
 
-    // --- sonido de fondo del nivel (QSoundEffect) ---
-    QSoundEffect *bgSound_ = nullptr;
-    QPropertyAnimation *bgFadeAnim_ = nullptr;
+    // --- música de fondo del nivel (streaming por AudioMixer) ---
+    bool levelMusic_ = false;          // se arrancó en este GameWindow
     void startLevelMusic();            // inicia loop con fade-in
     void fadeOutAndStopLevelMusic(int ms = 600); // fade-out y stop
     void stopLevelMusic();             // parada inmediata
@@ -78,16 +146,11 @@ private:
     QVector<EnemyItem*> enemies_;
     int currentShooterIndex = 0;
 
-    // sonido reutilizable de disparo enemigo (opcional, inicializar en constructor)
-    QSoundEffect *enemyShotSound_ = nullptr;
-    QSoundEffect *flamethrowerSound_ = nullptr;
-
     QLabel *healthBar_ = nullptr;
     void updateHealthBar(int lives);
 
     // Game Over / estado
     QLabel *gameOverLabel_ = nullptr;
-    QSoundEffect *deathMusic_ = nullptr;    // canción que suena cuando el player muere
     QPushButton *retryButton_ = nullptr;  // ⬅️ nuevo
     bool gameOver_ = false;
 
@@ -107,12 +170,23 @@ private:
 
 
     QList<TopDownEnemy*> survivalEnemies_; // Lista de enemigos rojos
-    QTimer *survivalTimer_ = nullptr;      // Timer de los 20 segundos
-    int survivalSecondsLeft_ = 20;         // Contador
+    int survivalSecondsLeft_ = 20;         // Contador (baja 1 por segundo de simulación)
+    int survivalWavesSpawned_ = 0;         // estadística (headless)
     QLabel *messageLabel_ = nullptr;       // Texto en pantalla
 
-    void spawnSurvivalWave();              // Función para generar 4 enemigos
+    // Cola de aparición: una oleada no se construye entera en un tick, se
+    // reparte entre varios (máximo kMaxSpawnsPerTick por tick y, en vivo,
+    // hasta spawnBudgetMs_ de tiempo real). Grabando/reproduciendo o en
+    // headless sólo cuenta el máximo, para que la simulación sea reproducible.
+    QVector<QPointF> survivalSpawnQueue_;
+    double spawnBudgetMs_ = 1.0;
+    static constexpr int kMaxSpawnsPerTick = 2;
+    void drainSpawnQueue();
+    void spawnSurvivalEnemy(const QPointF &pos);
+
+    void spawnSurvivalWave();              // Encola una oleada (se construye en drainSpawnQueue)
     void updateSurvivalTimer();            // Función que resta segundos
+    void scheduleSurvivalTick();           // programa el siguiente segundo en el reloj del mundo
 };
 
 #endif // GAMEWINDOW_H
@@ -0,0 +1,303 @@
+#include "GameWorld.h"
+#include "CoverItem.h"
+#include <algorithm>
+
+static QPointer<GameWorld> s_currentWorld;
+static quint64 s_lastGeneration = 0;
+
+// ----------------------------
+// StateHash
+// ----------------------------
+void StateHash::addBytes(const void *data, int len)
+{
+    const unsigned char *p = static_cast<const unsigned char*>(data);
+    for (int i = 0; i < len; ++i) {
+        h_ ^= p[i];
+        h_ *= 1099511628211ULL;
+    }
+}
+
+// ----------------------------
+// WorldEntity
+// ----------------------------
+WorldEntity::WorldEntity(Phase phase)
+    : phase_(phase)
+{
+    if (GameWorld *w = GameWorld::current()) w->add(this);
+}
+
+WorldEntity::~WorldEntity()
+{
+    leaveWorld();
+}
+
+void WorldEntity::leaveWorld()
+{
+    if (world_) world_->remove(this);
+    world_ = nullptr;
+}
+
+// ----------------------------
+// GameWorld
+// ----------------------------
+GameWorld::GameWorld(QObject *parent)
+    : QObject(parent), generation_(++s_lastGeneration)
+{
+    setSeed(1);
+}
+
+GameWorld::~GameWorld()
+{
+    clear();
+}
+
+GameWorld *GameWorld::current()
+{
+    return s_currentWorld.data();
+}
+
+void GameWorld::makeCurrent()
+{
+    s_currentWorld = this;
+}
+
+bool GameWorld::audioAllowed()
+{
+    GameWorld *w = current();
+    return !w || w->audioEnabled();
+}
+
+void GameWorld::setSeed(quint64 seed)
+{
+    seed_ = seed;
+
+    // splitmix64: semillas bien separadas para cada flujo a partir de una sola
+    quint64 x = seed;
+    for (QRandomGenerator &g : rngs_) {
+        x += 0x9E3779B97F4A7C15ULL;
+        quint64 z = x;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= (z >> 31);
+        const quint32 words[2] = { quint32(z), quint32(z >> 32) };
+        g = QRandomGenerator(words, 2);
+    }
+}
+
+QRandomGenerator &GameWorld::rng(RngStream stream)
+{
+    return rngs_[static_cast<int>(stream)];
+}
+
+QRandomGenerator *GameWorld::random(RngStream stream)
+{
+    if (GameWorld *w = current()) return &w->rng(stream);
+    return QRandomGenerator::global();
+}
+
+void GameWorld::add(WorldEntity *e)
+{
+    if (!e || e->world_ == this) return;
+    if (e->world_) e->world_->remove(e);
+    e->world_ = this;
+    // las que se agregan durante un step() empiezan a moverse en el siguiente tick
+    entities_[static_cast<int>(e->phase_)].append(e);
+}
+
+void GameWorld::remove(WorldEntity *e)
+{
+    if (!e) return;
+    QVector<WorldEntity*> &list = entities_[static_cast<int>(e->phase_)];
+    int idx = list.indexOf(e);
+    if (idx < 0) return;
+
+    // Durante el recorrido no movemos el vector: dejamos el hueco y se compacta al final
+    if (stepping_) list[idx] = nullptr;
+    else list.remove(idx);
+    e->world_ = nullptr;
+
+    // que las balas que quedan en este tick ya no lo vean
+    broadphase_.disable(e->colliderSlot_);
+    e->colliderSlot_ = -1;
+}
+
+void GameWorld::after(double seconds, QObject *context, std::function<void()> fn)
+{
+    if (!fn) return;
+    Pending p;
+    p.due = time_ + qMax(0.0, seconds);
+    p.seq = timerSeq_++;
+    p.guarded = (context != nullptr);
+    p.context = context;
+    p.fn = std::move(fn);
+    timers_.append(std::move(p));
+}
+
+void GameWorld::addCollider(QGraphicsItem *item)
+{
+    if (!item || staticColliders_.contains(item)) return;
+    staticColliders_.append(item);
+    if (item->type() == CoverItem::Type) coverDirty_ = true;
+}
+
+const CoverGrid &GameWorld::cover()
+{
+    if (!coverDirty_ && cover_.bounds() == broadphase_.bounds()) return cover_;
+
+    cover_.setBounds(broadphase_.bounds());
+    for (QGraphicsItem *it : staticColliders_) {
+        if (it->type() != CoverItem::Type || !it->scene()) continue;
+        // el rect exacto, sin el medio pixel del pen que trae sceneBoundingRect()
+        const CoverItem *c = static_cast<const CoverItem*>(it);
+        cover_.addRect(c->mapRectToScene(c->rect()));
+    }
+    coverDirty_ = false;
+    flowDirty_ = true;
+    return cover_;
+}
+
+void GameWorld::queryRadius(const QPointF &center, qreal radius, quint32 categoryMask, bool throughCover,
+                            SpatialHash::RadialHits &out)
+{
+    const int first = out.size();
+    broadphase_.queryRadius(center, radius, categoryMask, out);
+    if (throughCover) return;
+
+    // tapado si no se ve ni el punto más cercano de la caja ni su centro
+    const CoverGrid &grid = cover();
+    int w = first;
+    for (int k = first; k < out.size(); ++k) {
+        const QRectF &b = out[k].box;
+        const QPointF nearest(qBound(b.left(), center.x(), b.right()), qBound(b.top(), center.y(), b.bottom()));
+        if (!grid.lineClear(center, nearest) && !grid.lineClear(center, b.center())) continue;
+        out[w++] = out[k];
+    }
+    out.resize(w);
+}
+
+const FlowField &GameWorld::flowField(const QPointF &goal, qreal radius)
+{
+    const CoverGrid &grid = cover();
+    if (flowDirty_ || flow_.radius() != radius) {
+        flow_.build(grid, radius);
+        flowDirty_ = false;
+    }
+    flow_.update(goal);
+    return flow_;
+}
+
+void GameWorld::rebuildBroadphase()
+{
+    broadphase_.beginBuild();
+    for (QGraphicsItem *it : staticColliders_) {
+        if (it->scene()) broadphase_.add(it, collisionCategory(it));
+    }
+    for (WorldEntity *e : entities_[static_cast<int>(WorldEntity::Phase::Actors)]) {
+        if (!e) continue;
+        e->colliderSlot_ = -1;
+        QGraphicsItem *it = e->colliderItem();
+        if (it && it->scene()) e->colliderSlot_ = broadphase_.add(it, collisionCategory(it));
+    }
+    broadphase_.endBuild();
+}
+
+void GameWorld::runDueTimers()
+{
+    if (timers_.isEmpty()) return;
+
+    // Sacamos los vencidos antes de llamarlos: un callback puede programar otros
+    // (esos esperan al siguiente tick) o limpiar el mundo entero.
+    QVector<Pending> due;
+    for (int i = 0; i < timers_.size(); ) {
+        if (timers_[i].due <= time_) {
+            due.append(std::move(timers_[i]));
+            timers_.remove(i);
+        } else {
+            ++i;
+        }
+    }
+    std::sort(due.begin(), due.end(), [](const Pending &a, const Pending &b) {
+        if (a.due != b.due) return a.due < b.due;
+        return a.seq < b.seq;
+    });
+
+    const quint64 generation = generation_;
+    for (Pending &p : due) {
+        if (generation != generation_) break;  // un callback reinició el mundo
+        if (p.guarded && !p.context) continue; // el dueño ya no existe
+        p.fn();
+    }
+}
+
+void GameWorld::step(double dt)
+{
+    ++tick_;
+    time_ += dt;
+
+    runDueTimers();
+
+    stepping_ = true;
+    for (int phase = 0; phase < static_cast<int>(WorldEntity::Phase::Count); ++phase) {
+        QVector<WorldEntity*> &list = entities_[phase];
+        if (phase == static_cast<int>(WorldEntity::Phase::Projectiles)) bullets_.step(dt);
+
+        const int n = list.size(); // las nuevas esperan al siguiente tick
+        for (int i = 0; i < n && i < list.size(); ++i) {
+            WorldEntity *e = list[i];
+            if (e) e->step(dt);
+        }
+
+        // los actores ya se movieron: posiciones del tick para las colisiones
+        if (phase == static_cast<int>(WorldEntity::Phase::Actors)) rebuildBroadphase();
+    }
+    stepping_ = false;
+
+    // compactar huecos dejados por remove() durante el recorrido
+    for (QVector<WorldEntity*> &list : entities_) {
+        list.erase(std::remove(list.begin(), list.end(), nullptr), list.end());
+    }
+}
+
+void GameWorld::clear()
+{
+    generation_ = ++s_lastGeneration;
+    for (QVector<WorldEntity*> &list : entities_) {
+        for (WorldEntity *e : list) {
+            if (!e) continue;
+            e->world_ = nullptr;
+            e->colliderSlot_ = -1;
+        }
+        list.clear();
+    }
+    timers_.clear();
+    staticColliders_.clear();
+    coverDirty_ = true;
+    platforms_.clear();
+    broadphase_.reset();
+    bullets_.clear();
+    sprites_.clear();   // los items los borra la escena al reiniciar
+}
+
+void GameWorld::hashState(StateHash &h) const
+{
+    h.addInt(static_cast<qint64>(tick_));
+    h.addReal(time_);
+    h.addInt(timers_.size());
+    bullets_.hashState(h);
+    for (const QVector<WorldEntity*> &list : entities_) {
+        for (WorldEntity *e : list) {
+            if (e) e->hashState(h);
+        }
+    }
+}
+
+int GameWorld::entityCount() const
+{
+    int n = bullets_.count();
+    for (const QVector<WorldEntity*> &list : entities_) {
+        for (WorldEntity *e : list) {
+            if (e) ++n;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,196 @@
+#ifndef GAMEWORLD_H
+#define GAMEWORLD_H
+
+#pragma once
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include <QPointF>
+#include <QRandomGenerator>
+#include <functional>
+#include "SpatialHash.h"
+#include "CoverGrid.h"
+#include "FlowField.h"
+#include "CharacterController.h"
+#include "BulletSystem.h"
+#include "SpriteBatchItem.h"
+
+class GameWorld;
+
+// Huella (FNV-1a de 64 bits) del estado de la simulación en un tick. Se usa
+// en las repeticiones para detectar en qué tick se separan dos ejecuciones.
+// Los double se mezclan bit a bit: cualquier diferencia cuenta.
+class StateHash {
+public:
+    void addBytes(const void *data, int len);
+    void addInt(qint64 v) { addBytes(&v, sizeof(v)); }
+    void addReal(double v) { addBytes(&v, sizeof(v)); }
+    void addPoint(const QPointF &p) { addReal(p.x()); addReal(p.y()); }
+
+    quint64 value() const { return h_; }
+
+private:
+    quint64 h_ = 14695981039346656037ULL;
+};
+
+// Flujos de números aleatorios de la partida. Cada sistema tiene el suyo para
+// que un sorteo de más en uno (p.ej. la IA) no cambie lo que sale en otro.
+enum class RngStream { Spawn = 0, AI, Count };
+
+// Interfaz común de todo lo que avanza con la simulación (balas, granadas,
+// enemigos, efectos...). En vez de tener cada uno su propio QTimer a 60 Hz,
+// se registran en el GameWorld actual y éste los llama con step(dt) desde
+// GameWindow::onTick, siempre en el mismo orden.
+class WorldEntity {
+public:
+    // Orden de actualización dentro de un tick: primero los actores (se mueven),
+    // luego los proyectiles (chocan contra las posiciones ya actualizadas) y
+    // al final los efectos visuales.
+    enum class Phase { Actors = 0, Projectiles, Effects, Count };
+
+    explicit WorldEntity(Phase phase);
+    virtual ~WorldEntity();
+
+    virtual void step(double dt) = 0;
+
+    // Aporta al hash del tick lo que define a la entidad (posición, vida...)
+    virtual void hashState(StateHash &h) const { Q_UNUSED(h); }
+
+    // Item con el que se le puede pegar (sólo actores). nullptr = no colisiona.
+    virtual QGraphicsItem *colliderItem() { return nullptr; }
+
+    Phase phase() const { return phase_; }
+    bool inWorld() const { return !world_.isNull(); }
+
+protected:
+    // Deja de recibir step(). Llamar antes de removeItem()/deleteLater().
+    void leaveWorld();
+
+private:
+    friend class GameWorld;
+    Phase phase_;
+    QPointer<GameWorld> world_;
+    int colliderSlot_ = -1;     // posición en la broadphase del tick actual
+};
+
+class GameWorld : public QObject {
+    Q_OBJECT
+public:
+    explicit GameWorld(QObject *parent = nullptr);
+    ~GameWorld() override;
+
+    // Mundo en el que se registran las entidades nuevas (lo fija GameWindow)
+    static GameWorld *current();
+    void makeCurrent();
+
+    void add(WorldEntity *e);
+    void remove(WorldEntity *e);
+
+    // Igual que QTimer::singleShot pero en tiempo de simulación: sólo avanza
+    // cuando avanza el mundo. Si 'context' se destruye antes, no se llama.
+    void after(double seconds, QObject *context, std::function<void()> fn);
+
+    // Un paso fijo: temporizadores vencidos y luego entidades por fase
+    void step(double dt);
+
+    // Suelta todas las entidades y temporizadores (reinicio de nivel)
+    void clear();
+
+    // Modo sin audio (simulación headless): las entidades no crean ni
+    // reproducen sonido si el mundo actual lo tiene desactivado.
+    void setAudioEnabled(bool on) { audioEnabled_ = on; }
+    bool audioEnabled() const { return audioEnabled_; }
+    static bool audioAllowed();
+
+    // Semilla de la partida: de ella salen todos los flujos de rng(). Con la
+    // misma semilla y la misma entrada, la simulación es idéntica.
+    void setSeed(quint64 seed);
+    quint64 seed() const { return seed_; }
+    QRandomGenerator &rng(RngStream stream);
+
+    // Generador del mundo actual (o el global si no hay mundo)
+    static QRandomGenerator *random(RngStream stream);
+
+    // Broadphase: se reconstruye tras la fase de actores de cada tick con los
+    // colliderItem() de los actores más los colliders fijos (jugador,
+    // coberturas), que GameWindow registra con addCollider() y duran hasta clear().
+    SpatialHash &broadphase() { return broadphase_; }
+
+    // Efectos de área (granadas...): SpatialHash::queryRadius y, si
+    // 'throughCover' es false, sin lo que una cobertura tapa desde 'center'
+    // (rayo contra la rejilla de coberturas)
+    void queryRadius(const QPointF &center, qreal radius, quint32 categoryMask, bool throughCover,
+                     SpatialHash::RadialHits &out);
+    void addCollider(QGraphicsItem *item);
+
+    // Coberturas fijas (los CoverItem de addCollider) horneadas en bits sobre
+    // los límites de la broadphase. Se arma al pedirla y sólo se rehace si
+    // se agrega una cobertura, cambian los límites o tras invalidateCover().
+    const CoverGrid &cover();
+    void invalidateCover() { coverDirty_ = true; }
+
+    // Campo de flujo hacia 'goal' para cajas de 'radius' (enemigos del nivel
+    // 2). Lo comparten todos: se recalcula sólo cuando 'goal' cambia de celda
+    // o cambian las coberturas, el resto de las llamadas sólo lo devuelven.
+    const FlowField &flowField(const QPointF &goal, qreal radius);
+
+    // Suelo, plataformas y rampas del nivel de plataformas (lo que no es
+    // cobertura); los arma el setup del nivel y los lee PlayerItem
+    PlatformSurfaces &platforms() { return platforms_; }
+
+    // Balas del nivel (arreglos contiguos, no entidades sueltas); avanzan al
+    // principio de la fase de proyectiles.
+    BulletSystem &bullets() { return bullets_; }
+
+    // Escena del nivel y sus lotes de sprites (un item por textura para lo
+    // que hay de a cientos, como las balas). GameWindow la fija al crear el mundo.
+    void setScene(QGraphicsScene *scene) { sprites_.setScene(scene); }
+    SpriteBatches &sprites() { return sprites_; }
+
+    // Mezcla tiempo, temporizadores y el estado de todas las entidades
+    void hashState(StateHash &h) const;
+
+    // Distinta en cada mundo y tras cada clear() (única en todo el proceso):
+    // sirve para saber si algo guardado pertenece todavía a este nivel.
+    quint64 generation() const { return generation_; }
+
+    double time() const { return time_; }
+    quint64 tick() const { return tick_; }
+    int entityCount() const;
+
+private:
+    struct Pending {
+        double due;
+        quint64 seq;            // desempate: mismo 'due' => orden de creación
+        bool guarded;           // tenía contexto (si desaparece, no se dispara)
+        QPointer<QObject> context;
+        std::function<void()> fn;
+    };
+
+    void runDueTimers();
+    void rebuildBroadphase();
+
+    QVector<WorldEntity*> entities_[static_cast<int>(WorldEntity::Phase::Count)];
+    QVector<Pending> timers_;
+    QVector<QGraphicsItem*> staticColliders_;
+    SpatialHash broadphase_;
+    CoverGrid cover_;
+    bool coverDirty_ = true;
+    FlowField flow_;
+    bool flowDirty_ = true;                     // hay que volver a build()
+    PlatformSurfaces platforms_;
+    SpriteBatches sprites_;
+    BulletSystem bullets_{this};
+    quint64 timerSeq_ = 0;
+    quint64 generation_ = 0;    // cambia con cada clear() (ver generation())
+
+    quint64 seed_ = 0;
+    QRandomGenerator rngs_[static_cast<int>(RngStream::Count)];
+
+    double time_ = 0.0;
+    quint64 tick_ = 0;
+    bool stepping_ = false;
+    bool audioEnabled_ = true;
+};
+
+#endif // GAMEWORLD_H
@@ -0,0 +1,312 @@
+#include "MusicStream.h"
+#include <QDebug>
+#include <QThread>
+#include <QTimer>
+#include <QtEndian>
+#include <cstring>
+
+static const int kChannels = 2;
+static const int kReadFrames = 2048;   // frames fuente por lectura
+static const int kPumpMs = 20;
+
+MusicStream::MusicStream()
+{
+    for (Deck &d : decks_) d.ring.resize(kRingFrames * kChannels);
+
+    thread_ = new QThread;
+    thread_->setObjectName(QStringLiteral("MusicStream"));
+    worker_ = new QObject;
+    worker_->moveToThread(thread_);
+    thread_->start();
+
+    QMetaObject::invokeMethod(worker_, [this] {
+        timer_ = new QTimer(worker_);
+        timer_->setInterval(kPumpMs);
+        QObject::connect(timer_, &QTimer::timeout, worker_, [this] { pump(); });
+        timer_->start();
+    }, Qt::QueuedConnection);
+}
+
+MusicStream::~MusicStream()
+{
+    QMetaObject::invokeMethod(worker_, [this] {
+        delete timer_;
+        timer_ = nullptr;
+        for (Deck &d : decks_) d.file.close();
+    }, Qt::BlockingQueuedConnection);
+    thread_->quit();
+    thread_->wait();
+    delete worker_;
+    delete thread_;
+}
+
+// ----------------------------
+// Hilo de la GUI
+// ----------------------------
+void MusicStream::play(MusicTrack track, float volume, int fadeMs, bool loop)
+{
+    Request r;
+    r.valid = true;
+    r.track = track;
+    r.volume = qBound(0.0f, volume, 1.0f);
+    r.fadeMs = qMax(0, fadeMs);
+    r.loop = loop;
+    QMetaObject::invokeMethod(worker_, [this, r] { request(r); }, Qt::QueuedConnection);
+}
+
+void MusicStream::stop(int fadeMs)
+{
+    QMetaObject::invokeMethod(worker_, [this, fadeMs] {
+        pending_ = Request();
+        fadeOutAll(qMax(0, fadeMs));
+    }, Qt::QueuedConnection);
+}
+
+// ----------------------------
+// Hilo del streamer
+// ----------------------------
+void MusicStream::fadeTo(Deck &d, float target, int fadeMs)
+{
+    const int rate = rate_.load(std::memory_order_relaxed);
+    const float range = qMax(target, d.target.load(std::memory_order_relaxed));
+    const double frames = double(fadeMs) * rate / 1000.0;
+    d.step.store(frames >= 1.0 ? float(range / frames) : 1.0f, std::memory_order_relaxed);
+    d.target.store(target, std::memory_order_relaxed);
+}
+
+void MusicStream::fadeOutAll(int fadeMs)
+{
+    for (Deck &d : decks_) {
+        const int st = d.state.load(std::memory_order_acquire);
+        if (st == Starting || st == Playing) fadeTo(d, 0.0f, fadeMs);
+    }
+    active_ = -1;
+}
+
+void MusicStream::request(const Request &r)
+{
+    // misma pista sonando (y no saliendo): sólo volumen
+    if (active_ >= 0) {
+        Deck &d = decks_[active_];
+        const int st = d.state.load(std::memory_order_acquire);
+        if (d.track == r.track && (st == Starting || st == Playing)) {
+            d.loop = r.loop;
+            fadeTo(d, r.volume, r.fadeMs);
+            pending_ = Request();
+            return;
+        }
+    }
+
+    // la anterior sale con el mismo fundido con el que entra la nueva
+    fadeOutAll(r.fadeMs);
+    pending_ = r;
+    pump();
+}
+
+void MusicStream::pump()
+{
+    // liberar las que el audio ya soltó
+    for (int i = 0; i < 2; ++i) {
+        Deck &d = decks_[i];
+        if (d.state.load(std::memory_order_acquire) != Done) continue;
+        d.file.close();
+        d.readPos.store(0, std::memory_order_relaxed);
+        d.writePos.store(0, std::memory_order_relaxed);
+        d.eof.store(false, std::memory_order_relaxed);
+        d.state.store(Idle, std::memory_order_release);
+        if (active_ == i) active_ = -1;
+    }
+
+    // arrancar lo pedido en cuanto haya deck libre y se sepa la frecuencia
+    if (pending_.valid && rate_.load(std::memory_order_relaxed) > 0) {
+        int freeDeck = -1;
+        for (int i = 0; i < 2 && freeDeck < 0; ++i)
+            if (decks_[i].state.load(std::memory_order_acquire) == Idle) freeDeck = i;
+
+        if (freeDeck < 0) {
+            // tres cambios seguidos: se corta en seco lo que aún se iba apagando
+            for (Deck &d : decks_) fadeTo(d, 0.0f, 0);
+        } else {
+            Deck &d = decks_[freeDeck];
+            if (open(d, pending_)) {
+                fill(d);
+                d.target.store(0.0f, std::memory_order_relaxed);
+                fadeTo(d, pending_.volume, pending_.fadeMs);
+                d.state.store(Starting, std::memory_order_release);
+                active_ = freeDeck;
+            } else {
+                qWarning() << "MusicStream: no se pudo abrir" << musicPath(pending_.track);
+            }
+            pending_ = Request();
+        }
+    }
+
+    for (Deck &d : decks_) {
+        const int st = d.state.load(std::memory_order_acquire);
+        if (st == Starting || st == Playing) fill(d);
+    }
+}
+
+bool MusicStream::open(Deck &d, const Request &r)
+{
+    d.file.close();
+    d.file.setFileName(QString::fromLatin1(musicPath(r.track)));
+    if (!d.file.open(QIODevice::ReadOnly)) return false;
+
+    char riff[12];
+    if (d.file.read(riff, 12) != 12 || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0)
+        return false;
+
+    int format = 0;
+    d.dataStart = d.dataEnd = 0;
+    char head[8];
+    while (d.file.read(head, 8) == 8) {
+        const quint32 size = qFromLittleEndian<quint32>(head + 4);
+        const qint64 body = d.file.pos();
+        if (std::memcmp(head, "fmt ", 4) == 0 && size >= 16) {
+            char fmt[16];
+            if (d.file.read(fmt, 16) != 16) return false;
+            format = qFromLittleEndian<quint16>(fmt);
+            d.channels = qFromLittleEndian<quint16>(fmt + 2);
+            d.srcRate = int(qFromLittleEndian<quint32>(fmt + 4));
+            d.bits = qFromLittleEndian<quint16>(fmt + 14);
+        } else if (std::memcmp(head, "data", 4) == 0) {
+            d.dataStart = body;
+            d.dataEnd = qMin(body + qint64(size), d.file.size());
+            break;
+        }
+        d.file.seek(body + size + (size & 1));   // los chunks van alineados a 2 bytes
+    }
+
+    if (format != 1 || d.dataEnd <= d.dataStart || d.channels < 1 || d.channels > 2
+        || d.srcRate <= 0 || (d.bits != 8 && d.bits != 16)) {
+        return false;
+    }
+
+    d.file.seek(d.dataStart);
+    d.track = r.track;
+    d.loop = r.loop;
+    d.window.clear();
+    d.phase = 0.0;
+    return true;
+}
+
+void MusicStream::fill(Deck &d)
+{
+    if (d.eof.load(std::memory_order_relaxed)) return;
+
+    const int rate = rate_.load(std::memory_order_relaxed);
+    const double srcStep = double(d.srcRate) / rate;
+    const int stride = d.channels * d.bits / 8;
+    // lo máximo que puede salir de un bloque al remuestrear
+    const int maxOut = int(kReadFrames / srcStep) + 2;
+
+    readBuf_.resize(kReadFrames * stride);
+    quint32 w = d.writePos.load(std::memory_order_relaxed);
+
+    while (int(kRingFrames - (w - d.readPos.load(std::memory_order_acquire))) >= maxOut) {
+        qint64 left = d.dataEnd - d.file.pos();
+        if (left < stride) {
+            if (!d.loop) {
+                d.writePos.store(w, std::memory_order_release);
+                d.eof.store(true, std::memory_order_release);
+                return;
+            }
+            d.file.seek(d.dataStart);
+            left = d.dataEnd - d.dataStart;
+        }
+
+        const qint64 got = d.file.read(readBuf_.data(), qMin<qint64>(left, qint64(kReadFrames) * stride));
+        const int frames = int(qMax<qint64>(got, 0) / stride);
+        if (frames == 0) {
+            d.writePos.store(w, std::memory_order_release);
+            d.eof.store(true, std::memory_order_release);
+            return;
+        }
+
+        // a flotante estéreo detrás del último frame del bloque anterior
+        int base = d.window.size() / kChannels;
+        d.window.resize((base + frames) * kChannels);
+        const uchar *src = reinterpret_cast<const uchar*>(readBuf_.constData());
+        for (int i = 0; i < frames; ++i, ++base) {
+            for (int ch = 0; ch < kChannels; ++ch) {
+                const uchar *s = src + i * stride + (d.channels == 2 ? ch : 0) * (d.bits / 8);
+                d.window[base * kChannels + ch] = d.bits == 8 ? float((int(*s) - 128) * 256)
+                                                              : float(qFromLittleEndian<qint16>(s));
+            }
+        }
+
+        // interpolación lineal hacia la frecuencia de salida
+        const int wf = d.window.size() / kChannels;
+        const float *win = d.window.constData();
+        while (d.phase + 1.0 < wf) {
+            const int a = int(d.phase);
+            const float f = float(d.phase - a);
+            qint16 *out = d.ring.data() + (w & (kRingFrames - 1)) * kChannels;
+            for (int ch = 0; ch < kChannels; ++ch) {
+                const float v0 = win[a * kChannels + ch];
+                const float v1 = win[(a + 1) * kChannels + ch];
+                out[ch] = qint16(qBound(-32768.0f, v0 + (v1 - v0) * f, 32767.0f));
+            }
+            ++w;
+            d.phase += srcStep;
+        }
+        d.phase -= wf - 1;
+
+        // sólo queda el último frame para el siguiente bloque
+        std::memmove(d.window.data(), d.window.constData() + (wf - 1) * kChannels, kChannels * sizeof(float));
+        d.window.resize(kChannels);
+
+        d.writePos.store(w, std::memory_order_release);
+    }
+}
+
+// ----------------------------
+// Hilo de audio
+// ----------------------------
+void MusicStream::setOutputRate(int rate)
+{
+    rate_.store(rate, std::memory_order_relaxed);
+}
+
+void MusicStream::mix(float *out, int frames, float volume)
+{
+    for (Deck &d : decks_) {
+        const int st = d.state.load(std::memory_order_acquire);
+        if (st == Starting) {
+            d.gain = 0.0f;
+            d.state.store(Playing, std::memory_order_relaxed);
+        } else if (st != Playing) {
+            continue;
+        }
+
+        const float target = d.target.load(std::memory_order_relaxed);
+        const float step = d.step.load(std::memory_order_relaxed);
+        // eof antes que writePos: si ya terminó, writePos es el definitivo
+        const bool eof = d.eof.load(std::memory_order_acquire);
+        const quint32 w = d.writePos.load(std::memory_order_acquire);
+        const quint32 r = d.readPos.load(std::memory_order_relaxed);
+        const int n = qMin(frames, int(w - r));
+
+        const qint16 *ring = d.ring.constData();
+        float gain = d.gain;
+        for (int i = 0; i < n; ++i) {
+            if (gain < target) gain = qMin(target, gain + step);
+            else if (gain > target) gain = qMax(target, gain - step);
+            const qint16 *s = ring + ((r + i) & (kRingFrames - 1)) * kChannels;
+            const float g = gain * volume;
+            out[i * kChannels] += float(s[0]) * g;
+            out[i * kChannels + 1] += float(s[1]) * g;
+        }
+        // sin datos el fundido sigue corriendo: una pista que se apaga termina igual
+        if (n < frames) {
+            if (!eof) underruns_.fetch_add(1, std::memory_order_relaxed);
+            if (target <= 0.0f) gain = qMax(0.0f, gain - step * (frames - n));
+        }
+        d.gain = gain;
+        d.readPos.store(r + n, std::memory_order_release);
+
+        if ((target <= 0.0f && gain <= 0.0f) || (eof && r + n == w))
+            d.state.store(Done, std::memory_order_release);
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef MUSICSTREAM_H
+#define MUSICSTREAM_H
+
+#pragma once
+#include <QFile>
+#include <QVector>
+#include <atomic>
+#include "Assets.h"
+
+class QThread;
+class QTimer;
+class QObject;
+
+// Música en streaming para el AudioMixer. Nada se decodifica entero: un hilo
+// propio lee el WAV del recurso por bloques, lo pasa a estéreo de 16 bits a
+// la frecuencia de salida y lo deja en un anillo por pista; el hilo de audio
+// sólo consume de ahí. Con dos pistas (decks) el cambio de canción es un
+// fundido cruzado: la que sale baja mientras la nueva sube.
+//
+// Memoria residente: dos anillos de kRingFrames frames más un bloque de
+// lectura, sin importar lo que dure la canción.
+class MusicStream {
+public:
+    static constexpr int kRingFrames = 16384;   // ~340 ms a 48 kHz, potencia de 2
+
+    MusicStream();
+    ~MusicStream();
+
+    // --- hilo de la GUI (a través de AudioMixer) ---
+    // Si 'track' ya es la que suena sólo se ajusta su volumen
+    void play(MusicTrack track, float volume, int fadeMs, bool loop);
+    void stop(int fadeMs);
+
+    // --- hilo de audio ---
+    void setOutputRate(int rate);
+    void mix(float *out, int frames, float volume);
+
+    quint32 underruns() const { return underruns_.load(std::memory_order_relaxed); }
+
+private:
+    enum State : int {
+        Idle,       // del streamer
+        Starting,   // anillo cargado, esperando al hilo de audio
+        Playing,
+        Done        // el audio terminó con ella: el streamer la libera
+    };
+
+    struct Deck {
+        // sólo el streamer
+        QFile file;
+        MusicTrack track = MusicTrack::Count;
+        qint64 dataStart = 0;
+        qint64 dataEnd = 0;
+        int srcRate = 0;
+        int channels = 0;
+        int bits = 0;
+        bool loop = false;
+        QVector<float> window;      // último frame fuente + bloque nuevo (estéreo)
+        double phase = 0.0;
+
+        // anillo: el streamer escribe, el audio lee (posiciones en frames)
+        QVector<qint16> ring;
+        std::atomic<quint32> readPos{0};
+        std::atomic<quint32> writePos{0};
+        std::atomic<bool> eof{false};
+
+        // fundido: el audio lleva 'gain' hacia 'target' a 'step' por frame
+        std::atomic<int> state{Idle};
+        std::atomic<float> target{0.0f};
+        std::atomic<float> step{1.0f};
+        float gain = 0.0f;          // sólo el audio
+    };
+
+    struct Request {
+        bool valid = false;
+        MusicTrack track = MusicTrack::Count;
+        float volume = 1.0f;
+        int fadeMs = 0;
+        bool loop = true;
+    };
+
+    // --- hilo del streamer ---
+    void request(const Request &r);
+    void fadeOutAll(int fadeMs);
+    void pump();                            // cada kPumpMs
+    bool open(Deck &d, const Request &r);
+    void fill(Deck &d);
+    void fadeTo(Deck &d, float target, int fadeMs);
+
+    Deck decks_[2];
+    int active_ = -1;           // la pista en primer plano (la última pedida)
+    Request pending_;           // espera a que haya un deck libre
+    QVector<char> readBuf_;
+
+    std::atomic<int> rate_{0};
+    std::atomic<quint32> underruns_{0};
+
+    QThread *thread_ = nullptr;
+    QObject *worker_ = nullptr;     // contexto de las órdenes en el hilo del streamer
+    QTimer *timer_ = nullptr;
+};
+
+#endif // MUSICSTREAM_H
@@ -0,0 +1,79 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#pragma once
+#include <QVector>
+#include <QtGlobal>
+
+// Pool de capacidad fija para items de la escena que se crean y destruyen
+// seguido (granadas, explosiones). acquire() recicla uno dormido o, si aún
+// hay cupo, crea uno nuevo; release() lo devuelve. En régimen estable no se
+// reserva memoria.
+//
+// Los objetos son de la escena (el pool nunca los borra): al reiniciar el
+// nivel la escena los borra todos, y el pool los olvida en cuanto ve que la
+// generación del GameWorld cambió (syncGeneration).
+template <typename T>
+class ObjectPool {
+public:
+    explicit ObjectPool(int capacity)
+        : capacity_(capacity)
+    {
+        free_.reserve(capacity);
+    }
+
+    // create() sólo se llama si no hay dormidos y queda cupo.
+    // nullptr si el pool está lleno.
+    template <typename Create>
+    T *acquire(Create create)
+    {
+        T *obj = nullptr;
+        if (!free_.isEmpty()) {
+            obj = free_.takeLast();
+        } else if (allocated_ < capacity_) {
+            obj = create();
+            if (!obj) return nullptr;
+            ++allocated_;
+        } else {
+            ++rejected_;
+            return nullptr;
+        }
+        ++live_;
+        highWater_ = qMax(highWater_, live_);
+        return obj;
+    }
+
+    void release(T *obj)
+    {
+        if (!obj) return;
+        free_.append(obj);
+        --live_;
+    }
+
+    // El mundo se reinició: lo anterior ya lo borró la escena
+    void syncGeneration(quint64 generation)
+    {
+        if (generation == generation_) return;
+        generation_ = generation;
+        free_.clear();
+        live_ = 0;
+        allocated_ = 0;
+    }
+
+    int capacity() const { return capacity_; }
+    int live() const { return live_; }
+    int allocated() const { return allocated_; }
+    int highWater() const { return highWater_; }   // máximo de vivos a la vez (todo el proceso)
+    int rejected() const { return rejected_; }     // pedidos con el pool lleno
+
+private:
+    int capacity_;
+    QVector<T*> free_;
+    int live_ = 0;
+    int allocated_ = 0;
+    int highWater_ = 0;
+    int rejected_ = 0;
+    quint64 generation_ = 0;
+};
+
+#endif // OBJECTPOOL_H
@@ -3,6 +3,8 @@
 #include <QtMath>
 #include <QTransform>
 #include <QTimer>
+#include "GameWorld.h"
+#include "SpriteCache.h"
 
 PlayerItem::PlayerItem(QGraphicsItem *parent)
     : QObject(), QGraphicsPixmapItem(parent)
@@ -19,80 +21,45 @@ PlayerItem::~PlayerItem() {}
 
 void PlayerItem::loadFrames()
 {
-    // Cargar frames originales (ajusta nombres según tu .qrc)
-    idleFrames.clear();
-    idleFrames.append(QPixmap(":/images/images/Soldado.png"));
-    idleFrames.append(QPixmap(":/images/images/Soldado.png"));
-
-    runFrames.clear();
-    runFrames.append(QPixmap(":/images/images/Soldado1.png"));
-    runFrames.append(QPixmap(":/images/images/Soldado4.png"));
-    runFrames.append(QPixmap(":/images/images/Soldado2.png"));
+    // Todo sale de SpriteCache por id (AssetList.h): en un reinicio de
+    // nivel no se decodifica ni se espeja nada de nuevo
+    struct Frame { SpriteId normal, flipped; };
+    static const Frame kIdle[] = {
+        { SpriteId::PlayerIdle, SpriteId::PlayerIdleFlip },
+        { SpriteId::PlayerIdle, SpriteId::PlayerIdleFlip },
+    };
+    static const Frame kRun[] = {
+        { SpriteId::PlayerRun1, SpriteId::PlayerRun1Flip },
+        { SpriteId::PlayerRun2, SpriteId::PlayerRun2Flip },
+        { SpriteId::PlayerRun3, SpriteId::PlayerRun3Flip },
+    };
 
-    // intentar cargar frames de agachado (si existen en tu qrc)
-    crouchFrames.clear();
-    QPixmap c1(":/images/images/Soldado_abajo.png");
-    if (!c1.isNull()) {
-        crouchFrames.append(c1);
-    } else {
-        // fallback: crear versión escalada del idle para simular agachado
-        if (!idleFrames.isEmpty() && !idleFrames[0].isNull()) {
-            QPixmap scaled = idleFrames[0].scaled(idleFrames[0].width(), qMax(1, idleFrames[0].height() * 60 / 100),
-                                                  Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-            crouchFrames.append(scaled);
-        }
-    }
-
-    // --- Crear versiones volteadas (mirror) una sola vez para rendimiento ---
+    idleFrames.clear();
     idleFramesFlipped.clear();
-    for (const QPixmap &p : idleFrames) {
-        if (p.isNull()) {
-            idleFramesFlipped.append(QPixmap());
-            continue;
-        }
-        QTransform t; t.scale(-1, 1);
-        idleFramesFlipped.append(p.transformed(t));
+    for (const Frame &f : kIdle) {
+        idleFrames.append(SpriteCache::get(f.normal));
+        idleFramesFlipped.append(SpriteCache::get(f.flipped));
     }
 
+    runFrames.clear();
     runFramesFlipped.clear();
-    for (const QPixmap &p : runFrames) {
-        if (p.isNull()) {
-            runFramesFlipped.append(QPixmap());
-            continue;
-        }
-        QTransform t; t.scale(-1, 1);
-        runFramesFlipped.append(p.transformed(t));
+    for (const Frame &f : kRun) {
+        runFrames.append(SpriteCache::get(f.normal));
+        runFramesFlipped.append(SpriteCache::get(f.flipped));
     }
 
+    crouchFrames.clear();
     crouchFramesFlipped.clear();
-    for (const QPixmap &p : crouchFrames) {
-        if (p.isNull()) {
-            crouchFramesFlipped.append(QPixmap());
-            continue;
-        }
-        QTransform t; t.scale(-1, 1);
-        crouchFramesFlipped.append(p.transformed(t));
-    }
+    crouchFrames.append(SpriteCache::get(SpriteId::PlayerCrouch));
+    crouchFramesFlipped.append(SpriteCache::get(SpriteId::PlayerCrouchFlip));
 
     // === Sprite de salto ===
-    jumpFrame_ = QPixmap(":/images/images/Soldado_arriba.png"); // ajusta el nombre a tu archivo real
-    if (jumpFrame_.isNull()) {
-        qDebug() << "⚠️ No se encontró el sprite de salto";
-    } else {
-        QTransform t; t.scale(-1, 1);
-        jumpFrameFlipped_ = jumpFrame_.transformed(t);
-    }
+    jumpFrame_ = SpriteCache::get(SpriteId::PlayerJump);
+    jumpFrameFlipped_ = SpriteCache::get(SpriteId::PlayerJumpFlip);
 
     // === Sprite de muerte (tumbado) ===
-    deadPixmap_ = QPixmap(":/images/images/Soldado_muerto.png");
-    if (deadPixmap_.isNull()) {
-        qDebug() << "⚠️ No se encontró el sprite de jugador muerto (Soldado_muerto.png)";
-    } else {
-        // opcional: escalarlo al tamaño de los demás (ajusta si hace falta)
-        const QSize targetSize(100, 106);
-        deadPixmap_ = deadPixmap_.scaled(targetSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-    }
-
+    // escalado al tamaño de los demás (ajusta en AssetList.h si hace falta)
+    deadPixmap_ = SpriteCache::get(SpriteId::PlayerDead);
 }
 
 void PlayerItem::setFrameAndOffset(const QPixmap &pix, bool alignFeet)
@@ -100,23 +67,23 @@ void PlayerItem::setFrameAndOffset(const QPixmap &pix, bool alignFeet)
     if (pix.isNull()) return;
     setPixmap(pix);
     if (alignFeet) {
-        // pies en el suelo: offset Y = -height para que pos().y sea la línea de los pies
-        setOffset(-pixmap().width()/2, -pixmap().height() + 50);
+        // la base del sprite sobre los pies de la caja (hitbox())
+        setOffset(-pixmap().width()/2, -pixmap().height() + kFeetBelowPos);
     } else {
         // centrar verticalmente (tu implementación anterior)
         setOffset(-pixmap().width()/2, -pixmap().height()/2);
     }
 }
 
-void PlayerItem::moveLeft()
+void PlayerItem::moveLeft(double dt)
 {
     if (!isAlive()) return; // bloquear movimiento si está muerto
-    vx = qMax(vx - accel * (1.0/60.0), -currentMaxSpeed);
+    vx = qMax(vx - accel * dt, -currentMaxSpeed);
 }
-void PlayerItem::moveRight()
+void PlayerItem::moveRight(double dt)
 {
     if (!isAlive()) return;
-    vx = qMin(vx + accel * (1.0/60.0), currentMaxSpeed);
+    vx = qMin(vx + accel * dt, currentMaxSpeed);
 }
 void PlayerItem::stopMoving()
 {
@@ -169,6 +136,13 @@ void PlayerItem::stopCrouch()
     currentFrame = 0;
 }
 
+QRectF PlayerItem::hitbox() const
+{
+    const qreal h = crouching ? kCrouchHitHeight : kHitHeight;
+    const qreal feet = pos().y() + kFeetBelowPos;
+    return QRectF(pos().x() - kHitWidth / 2, feet - h, kHitWidth, h);
+}
+
 void PlayerItem::applyPhysics(double dt)
 {
     // fricción horizontal
@@ -179,120 +153,38 @@ void PlayerItem::applyPhysics(double dt)
         else vx -= sign * dec;
     }
 
-    // gravedad
-    vy += gravity * dt;
-
-    // guardamos la posición anterior COMPLETA (antes de mover nada)
-    QPointF prevPos = pos();
-
-    // -------------------------
-    // 1) MOVIMIENTO HORIZONTAL
-    // -------------------------
-    QPointF tryH = prevPos;
-    tryH.rx() += vx * dt;
-    setPos(tryH);
-
-    QList<QGraphicsItem*> collH = collidingItems();
-    bool horizontalCollision = false;
-    QGraphicsRectItem *hitRectH = nullptr;
-
-    for (QGraphicsItem *it : collH) {
-        QVariant tag = it->data(0);
-        if (tag.isValid() && tag.toString() == QLatin1String("cover")) {
-            hitRectH = dynamic_cast<QGraphicsRectItem*>(it);
-            if (hitRectH) { horizontalCollision = true; break; }
-        }
-    }
-
-    if (horizontalCollision && hitRectH) {
-        // colocamos al jugador justo al borde del rectángulo para que pueda retroceder.
-        const double halfW = static_cast<double>(pixmap().width()) / 2.0;
-        QRectF rScene = hitRectH->sceneBoundingRect();
-        // Si te movías a la derecha (vx > 0), te posicionamos a la izquierda del cover
-        if (vx > 0) {
-            double newX = rScene.left() - halfW - 0.5; // 0.5 pixel de margen para evitar solapamiento
-            setPos(QPointF(newX, pos().y()));
-        }
-        // Si te movías a la izquierda (vx < 0), te posicionamos a la derecha del cover
-        else if (vx < 0) {
-            double newX = rScene.right() + halfW + 0.5;
-            setPos(QPointF(newX, pos().y()));
-        } else {
-            // caso raro: si vx == 0, revertimos a prev X para seguridad
-            setPos(QPointF(prevPos.x(), pos().y()));
-        }
-
-        // cancelamos la componente hacia el obstáculo, pero permitimos inversión inmediata:
-        // si venías hacia la derecha dejamos vx = qMin(vx, 0.0) (efectivamente 0 o negativo es permitido)
-        if (vx > 0) vx = 0;
-        else if (vx < 0) vx = 0; // si venías hacia la izquierda también lo cancelamos
-        // no dejamos vx bloqueado en sentido contrario — futuros inputs cambiarán vx.
-    }
-
-    // -------------------------
-    // 2) MOVIMIENTO VERTICAL
-    // -------------------------
-    // Partimos de la posición actual tras resolver X (permite "pararse encima")
-    QPointF beforeV = pos();
-    QPointF tryV = beforeV;
-    tryV.ry() += vy * dt;
-    setPos(tryV);
-
-    QList<QGraphicsItem*> collV = collidingItems();
-    bool landed = false;
-    for (QGraphicsItem *it : collV) {
-        QVariant tag = it->data(0);
-        if (tag.isValid() && tag.toString() == QLatin1String("cover")) {
-            QGraphicsRectItem *r = dynamic_cast<QGraphicsRectItem*>(it);
-            if (!r) continue;
-
-            QRectF rScene = r->sceneBoundingRect();
-            double topY = rScene.top();
-
-            // línea de pies del jugador: tu convención es pos().y = pies
-            // usamos prevPos (antes de mover nada) para ver si venías desde arriba
-            double prevFeetY = prevPos.y();
-            double tryFeetY = tryV.y();
-
-            // Ajuste visual usado para alinear pies con superficie:
-            const double playerFeetOffset = static_cast<double>(pixmap().height()) - 50.0;
-
-            // Si venías cayendo y cruzaste la línea superior del cover -> aterrizaje válido
-            if (vy > 0 && prevFeetY <= topY && tryFeetY >= topY) {
-                double targetY = topY - playerFeetOffset;
-                setPos(QPointF(pos().x(), targetY));
-                vy = 0;
-                onGround = true;
-                landed = true;
-                break;
-            }
-
-            // Si venías desde abajo (saliendo hacia arriba) y golpeas el techo del cover:
-            if (vy < 0 && prevFeetY >= topY && tryFeetY <= topY) {
-                // revertir Y (mantenerse) y cancelar vy — evita "pegarse" al techo
-                setPos(QPointF(pos().x(), prevPos.y()));
-                vy = 0;
-                landed = false;
-                break;
-            }
-        }
+    // Coberturas (rejilla de GameWorld) y superficies del nivel: las que la
+    // caja puede alcanzar en este tick se juntan una sola vez
+    GameWorld *world = GameWorld::current();
+    static const PlatformSurfaces kNoSurfaces;
+    const PlatformSurfaces &surfaces = world ? world->platforms() : kNoSurfaces;
+
+    QRectF box = hitbox();
+    const QPointF offset = pos() - box.topLeft();
+    const double reachX = qAbs(vx) * dt;
+    const double reachY = (qAbs(vy) + gravity * dt) * dt;
+    controller_.gather(world ? &world->cover() : nullptr,
+                       box.adjusted(-reachX, -reachY, reachX, reachY));
+
+    // Subpasos: gravedad y barrido de la caja (tiempo de impacto en X y en Y)
+    const bool wasOnGround = onGround;
+    const double h = dt / kSubsteps;
+    QPointF vel(vx, vy);
+    for (int i = 0; i < kSubsteps; ++i) {
+        vel.ry() += gravity * h;
+        const CharacterController::Result r = controller_.move(box, vel, h, onGround, surfaces);
+        onGround = r.onGround;
     }
-
-    // Si no aterrizamos sobre un cover, comprobamos suelo global
-    if (!landed) {
-        const double groundY = 480.0;
-        if (pos().y() >= groundY) {
-            setPos(QPointF(pos().x(), groundY));
-            vy = 0;
-            if (!onGround) {
-                onGround = true;
-                const QVector<QPixmap> *frames = facingLeft ? &idleFramesFlipped : &idleFrames;
-                if (frames && !frames->isEmpty()) {
-                    setFrameAndOffset(frames->at(0), true);
-                }
-            }
-        } else {
-            onGround = false;
+    vx = vel.x();
+    vy = vel.y();
+    setPos(box.topLeft() + offset);
+
+    // al aterrizar, volver al frame quieto (si no, el de salto sigue hasta
+    // el próximo cambio de animación)
+    if (onGround && !wasOnGround) {
+        const QVector<QPixmap> *frames = facingLeft ? &idleFramesFlipped : &idleFrames;
+        if (frames && !frames->isEmpty()) {
+            setFrameAndOffset(frames->at(0), true);
         }
     }
 
@@ -387,14 +279,20 @@ void PlayerItem::takeDamage(int amount)
 
     // feedback visual: parpadeo corto (igual que EnemyItem)
     // ponemos opacidad baja y la restablecemos rápidamente
+    // (en tiempo de simulación: la invulnerabilidad influye en el resultado)
     setOpacity(0.6);
-    QTimer::singleShot(120, this, [this]() {
-        setOpacity(1.0);
-    });
-
-    // si quieres prevenir daño inmediato sucesivo, puedes activar invulnerable_ por un corto tiempo:
     invulnerable_ = true;
-    QTimer::singleShot(350, this, [this]() { invulnerable_ = false; });
+    if (GameWorld *world = GameWorld::current()) {
+        world->after(0.12, this, [this]() {
+            setOpacity(1.0);
+        });
+
+        // si quieres prevenir daño inmediato sucesivo, puedes activar invulnerable_ por un corto tiempo:
+        world->after(0.35, this, [this]() { invulnerable_ = false; });
+    } else {
+        QTimer::singleShot(120, this, [this]() { setOpacity(1.0); });
+        QTimer::singleShot(350, this, [this]() { invulnerable_ = false; });
+    }
 
     // si llegó a 0 -> mostrar sprite muerto y emitir playerDied
     if (lives_ == 0) {
@@ -5,12 +5,17 @@
 #include <QGraphicsPixmapItem>
 #include <QObject>
 #include <QVector>
+#include "Collision.h"
+#include "CharacterController.h"
 
 class QTimer;
 
 class PlayerItem : public QObject, public QGraphicsPixmapItem {
     Q_OBJECT
 public:
+    enum { Type = PlayerItemType };
+    int type() const override { return Type; }
+
     explicit PlayerItem(QGraphicsItem *parent = nullptr);
     ~PlayerItem() override;
 
@@ -28,8 +33,9 @@ public:
 
     bool isFacingLeft() const { return facingLeft; }
 
-    void moveLeft();
-    void moveRight();
+    // dt = paso fijo de simulación (acelera proporcional al tiempo)
+    void moveLeft(double dt);
+    void moveRight(double dt);
     void stopMoving();
     void jump();
 
@@ -45,6 +51,14 @@ public:
     void takeDamage(int amount = 1);
     bool isAlive() const { return lives_ > 0; }
 
+    // Caja de colisión fija (no depende del frame): la base son los pies,
+    // kFeetBelowPos px por debajo de pos(); agachado es más baja.
+    static constexpr qreal kHitWidth = 50.0;
+    static constexpr qreal kHitHeight = 100.0;
+    static constexpr qreal kCrouchHitHeight = 70.0;
+    static constexpr qreal kFeetBelowPos = 50.0;    // en el suelo (530) pos().y es 480
+    QRectF hitbox() const;
+
 private:
     // física
     double vx = 0.0;        // px/s
@@ -59,6 +73,10 @@ private:
 
     bool onGround = false;
 
+    // la física corre a kSubsteps veces el tick (240 Hz)
+    static constexpr int kSubsteps = 4;
+    CharacterController controller_;
+
     // animación
     QVector<QPixmap> idleFrames;
     QVector<QPixmap> runFrames;
@@ -1,95 +1,159 @@
 #include "Projectile.h"
 #include "EnemyItem.h"
+#include "TopDownEnemy.h"
 
-#include <QTimer>
-#include <QGraphicsEllipseItem>
 #include <QBrush>
 #include <QPen>
 #include <QGraphicsScene>
 #include <QDebug>
 #include <QtMath>
 
-#include <QSoundEffect>
-#include <QCoreApplication>
-#include <QUrl>
+#include "AudioMixer.h"
 
 #include <BunkerBossItem.h>
+#include "SpriteCache.h"
 
-QSoundEffect* ProjectileItem::explosionSound_ = nullptr;
-QPixmap* ProjectileItem::explosionPixmapPtr_ = nullptr;
 
+// Capacidad fija: más granadas en el aire que esto no se lanzan
+static ObjectPool<ProjectileItem> s_grenadePool(16);
+static ObjectPool<QGraphicsPixmapItem> s_explosionPool(16);
 
-// constructor...
-ProjectileItem::ProjectileItem(double v0, double angleDegrees, QGraphicsScene *scene, QGraphicsItem *parent)
-    : QObject(), QGraphicsPixmapItem(parent), scene_(scene)
+static const double kExplosionTime = 0.3;
+static const double kRadius = 12.0;     // mitad del sprite (24x24)
+// lo que la explosión daña (y con lo que la granada revienta al tocarlo)
+static const quint32 kDamageMask = categoryBit(CollisionCategory::Soldier) |
+                                   categoryBit(CollisionCategory::Bunker) |
+                                   categoryBit(CollisionCategory::RedEnemy);
+
+const ObjectPool<ProjectileItem> &ProjectileItem::pool()
 {
-    // usa imagen de granada si existe, sino no pinta nada
-    QPixmap pix(":/images/images/granade.png");
-    if (!pix.isNull()) {
-        setPixmap(pix.scaled(24,24,Qt::KeepAspectRatio,Qt::SmoothTransformation));
-        setOffset(-pixmap().width()/2, -pixmap().height()/2);
-    }
+    return s_grenadePool;
+}
+
+const ObjectPool<QGraphicsPixmapItem> &ProjectileItem::explosionPool()
+{
+    return s_explosionPool;
+}
+
+ProjectileItem *ProjectileItem::launch(const QPointF &pos, double v0, double angleDegrees, QGraphicsScene *scene)
+{
+    GameWorld *world = GameWorld::current();
+    if (!scene || !world) return nullptr;
+
+    // lo del nivel anterior ya lo borró la escena
+    s_grenadePool.syncGeneration(world->generation());
+    ProjectileItem *p = s_grenadePool.acquire([scene]() {
+        ProjectileItem *created = new ProjectileItem(scene);
+        scene->addItem(created);
+        return created;
+    });
+    if (!p) return nullptr;
+
+    p->reset(pos, v0, angleDegrees);
+    world->add(p);
+    return p;
+}
+
+// constructor: sólo lo que no cambia entre usos (sprite, sonido)
+ProjectileItem::ProjectileItem(QGraphicsScene *scene, QGraphicsItem *parent)
+    : QObject(), QGraphicsPixmapItem(parent), WorldEntity(Phase::Projectiles), scene_(scene)
+{
+    setPixmap(SpriteCache::get(SpriteId::Grenade));
+    setOffset(-pixmap().width()/2, -pixmap().height()/2);
+}
 
+void ProjectileItem::reset(const QPointF &pos, double v0, double angleDegrees)
+{
     double ang = qDegreesToRadians(angleDegrees);
     vx = v0 * qCos(ang);
     vy = -v0 * qSin(ang); // y hacia abajo es positivo
+    elapsed = 0.0;
+    exploded_ = false;
+    setPos(pos);
+    show();
+}
 
-    timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, &ProjectileItem::onStep);
-    timer->start(1000/60);
-
-    // carga perezosa del sprite de explosión (solo después de que exista QApplication)
-    if (!explosionPixmapPtr_) {
-        QPixmap px(":/images/images/granada_explosion.png"); // ajusta ruta si hace falta
-        if (!px.isNull()) {
-            // guardamos en heap un QPixmap ya escalado, listo para reutilizar
-            explosionPixmapPtr_ = new QPixmap(px.scaled(160, 160, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        } else {
-            qDebug() << "Projectile: explosion sprite NOT found at :/images/images/granada_explosion.png";
-            // dejamos explosionPixmapPtr_ == nullptr si no existe
-        }
-    }
-
+void ProjectileItem::despawn()
+{
+    leaveWorld();
+    hide();
+    s_grenadePool.release(this);
+}
 
-    if (!explosionSound_) {
-        explosionSound_ = new QSoundEffect(qApp);
-        explosionSound_->setSource(QUrl(QStringLiteral("qrc:/sound/sounds/granada.wav")));
-        explosionSound_->setLoopCount(1);
-        explosionSound_->setVolume(0.9f);
-        //explosionSound_->play();
-        //explosionSound_->stop();
-    }
+ProjectileItem::~ProjectileItem()
+{
+}
 
+void ProjectileItem::hashState(StateHash &h) const
+{
+    h.addPoint(pos());
+    h.addReal(vx);
+    h.addReal(vy);
+    h.addInt(exploded_);
 }
 
-ProjectileItem::~ProjectileItem()
+bool ProjectileItem::firstImpact(double dt, double *tHit) const
 {
-    if (timer) timer->stop();
+    const QPointF p0 = pos();
+    const QPointF v(vx, vy);
+    double best = dt + 1.0;
+    double t;
+
+    // suelo del nivel (GameWorld::platforms): un semiplano, subido el radio
+    GameWorld *world = GameWorld::current();
+    const double floorY = world ? world->platforms().floorY : qInf();
+    if (qIsFinite(floorY) && parabolaHitsRect(p0, v, gravity, dt, QRectF(-1e6, floorY - kRadius, 2e6, 1e6), &t))
+        best = t;
+
+    // caja que cubre el arco del paso (con el vértice si cae adentro)
+    const QPointF p1 = p0 + v * dt + QPointF(0, 0.5 * gravity * dt * dt);
+    double top = qMin(p0.y(), p1.y()), bottom = qMax(p0.y(), p1.y());
+    const double tApex = -vy / gravity;
+    if (tApex > 0.0 && tApex < dt) top = qMin(top, p0.y() + vy * tApex + 0.5 * gravity * tApex * tApex);
+    const QRectF reach = QRectF(QPointF(qMin(p0.x(), p1.x()), top), QPointF(qMax(p0.x(), p1.x()), bottom))
+                             .adjusted(-kRadius, -kRadius, kRadius, kRadius);
+
+    // coberturas y lo que la explosión daña: la caja de cada uno inflada
+    // por el radio de la granada contra el arco exacto
+    if (world) {
+        SpatialHash::Candidates items;
+        world->broadphase().query(reach, categoryBit(CollisionCategory::Cover) | kDamageMask, items);
+        for (QGraphicsItem *it : items) {
+            if (EnemyItem *enemy = qgraphicsitem_cast<EnemyItem*>(it)) {
+                if (!enemy->isAlive()) continue;
+            } else if (BunkerBossItem *bunker = qgraphicsitem_cast<BunkerBossItem*>(it)) {
+                if (!bunker->isAlive()) continue;
+            } else if (TopDownEnemy *enemy = qgraphicsitem_cast<TopDownEnemy*>(it)) {
+                if (!enemy->isAlive()) continue;
+            }
+            const QRectF box = it->sceneBoundingRect().adjusted(-kRadius, -kRadius, kRadius, kRadius);
+            if (parabolaHitsRect(p0, v, gravity, dt, box, &t) && t < best) best = t;
+        }
+    }
+
+    if (best > dt) return false;
+    *tHit = best;
+    return true;
 }
 
-void ProjectileItem::onStep()
+void ProjectileItem::step(double dt)
 {
-    double dt = 1.0/60.0;
     elapsed += dt;
 
-    vy += gravity * dt;
+    // Detección continua: el arco exacto del paso (no sólo dónde termina)
+    // contra el suelo y lo que esté en el camino; explota en el primer contacto
+    double t = dt;
+    const bool hit = !exploded_ && firstImpact(dt, &t);
 
-    QPointF p = pos();
-    p.rx() += vx * dt;
-    p.ry() += vy * dt;
-    setPos(p);
+    setPos(pos() + QPointF(vx * t, vy * t + 0.5 * gravity * t * t));
+    vy += gravity * t;
 
-    // colisión con suelo (ajusta)
-    if (!exploded_ && p.y() >= 480) {
+    if (hit) {
         explode();
         return;
     }
 
-
-    if (elapsed > lifeTime) {
-        if (scene_) scene_->removeItem(this);
-        deleteLater();
-    }
+    if (elapsed > lifeTime) despawn();
 }
 
 void ProjectileItem::explode()
@@ -98,82 +162,71 @@ void ProjectileItem::explode()
     if (exploded_) return;
     exploded_ = true;
 
-    // parar timer para evitar que onStep vuelva a llamar a explode()
-    if (timer) {
-        timer->stop();
-        disconnect(timer, &QTimer::timeout, this, &ProjectileItem::onStep);
-    }
-
-    if (explosionSound_) {
-        explosionSound_->play();
-    }
-
-    // Si tenemos sprite de explosión válido, crear QGraphicsPixmapItem
-    QGraphicsPixmapItem *expSprite = nullptr;
-    if (explosionPixmapPtr_ && !explosionPixmapPtr_->isNull()) {
-        expSprite = new QGraphicsPixmapItem(*explosionPixmapPtr_);
-        expSprite->setOffset(-explosionPixmapPtr_->width()/2, -explosionPixmapPtr_->height()/2);
-        expSprite->setPos(pos());
-        expSprite->setZValue(60);
-        if (scene_) scene_->addItem(expSprite);
-    } else {
-        // fallback visual: el círculo que ya tenías
-        QGraphicsEllipseItem *e = new QGraphicsEllipseItem(-160/2, -160/2, 160, 160);
-        e->setPos(pos());
-        e->setBrush(QBrush(QColor(255,140,0,140)));
-        e->setPen(QPen(Qt::NoPen));
-        if (scene_) scene_->addItem(e);
-        // programar la eliminación del círculo (igual que el sprite)
-        QTimer::singleShot(300, [e]() {
-            if (e->scene()) e->scene()->removeItem(e);
-            delete e;
+    // salir del mundo para que step() no vuelva a llamar a explode()
+    leaveWorld();
+    GameWorld *world = GameWorld::current();
+
+    AudioMixer::play(SoundId::Explosion, 0.9f);
+
+    // Sprite de explosión reciclado del pool
+    if (scene_ && world) {
+        s_explosionPool.syncGeneration(world->generation());
+        QGraphicsScene *scene = scene_;
+        QGraphicsPixmapItem *expSprite = s_explosionPool.acquire([scene]() {
+            const QPixmap pix = SpriteCache::get(SpriteId::GrenadeBlast);
+            QGraphicsPixmapItem *item = new QGraphicsPixmapItem(pix);
+            item->setOffset(-pix.width()/2, -pix.height()/2);
+            item->setZValue(60);
+            scene->addItem(item);
+            return item;
         });
+
+        // dormirlo tras un corto tiempo (temporizador del mundo: si se
+        // reinicia el nivel antes, la escena ya lo borró y el pool lo olvida)
+        if (expSprite) {
+            expSprite->setPos(pos());
+            expSprite->show();
+            world->after(kExplosionTime, world, [expSprite]() {
+                expSprite->hide();
+                s_explosionPool.release(expSprite);
+            });
+        }
     }
 
-    // daño radial (igual que antes)
+    // Daño radial: lo que la caja de cada uno tenga dentro del radio, con
+    // atenuación por distancia; lo que queda detrás de una cobertura no recibe
     const double R = 80.0; // radio de explosion
     const double baseDamage = 100.0;
 
-    if (scene_) {
-        QList<QGraphicsItem*> items = scene_->items(QRectF(pos().x()-R, pos().y()-R, R*2, R*2));
-        for (QGraphicsItem *it : items) {
-            if (!it || it == this) continue;
-            EnemyItem *enemy = dynamic_cast<EnemyItem*>(it);
-            if (enemy && enemy->isAlive()) {
-                QPointF center = enemy->pos();
-                double d = QLineF(center, pos()).length();
-                double factor = 1.0 - (d / R);
-                if (factor <= 0.0) continue;
-                int damage = qMax(1, static_cast<int>(std::round(baseDamage * factor)));
-                enemy->takeDamage(damage, true);
+    if (scene_ && world) {
+        SpatialHash::RadialHits hits;
+        world->queryRadius(pos(), R, kDamageMask, false, hits);
+        for (const SpatialHash::RadialHit &h : hits) {
+            const int damage = qMax(1, static_cast<int>(std::round(baseDamage * h.falloff)));
+            switch (h.category) {
+            case CollisionCategory::Soldier: {
+                EnemyItem *enemy = static_cast<EnemyItem*>(h.item);
+                if (enemy->isAlive()) enemy->takeDamage(damage, true);
+                break;
             }
-
-            // --- AÑADIR ESTE BLOQUE NUEVO ---
-            BunkerBossItem *bunker = dynamic_cast<BunkerBossItem*>(it);
-            if (bunker && bunker->isAlive()) {
-                QPointF center = bunker->pos(); // (O ajusta al centro real)
-                double d = QLineF(center, pos()).length();
-                double factor = 1.0 - (d / R);
-                if (factor <= 0.0) continue;
-
-                int damage = qMax(1, static_cast<int>(std::round(baseDamage * factor)));
-                bunker->takeDamage(damage); // Aplicar daño de explosión
+            case CollisionCategory::Bunker: {
+                BunkerBossItem *bunker = static_cast<BunkerBossItem*>(h.item);
+                if (bunker->isAlive()) bunker->takeDamage(damage); // Aplicar daño de explosión
+                break;
+            }
+            case CollisionCategory::RedEnemy: {
+                TopDownEnemy *enemy = static_cast<TopDownEnemy*>(h.item);
+                if (enemy->isAlive()) enemy->takeDamage(damage);
+                break;
+            }
+            default:
+                break;
             }
-            // --- FIN DEL BLOQUE NUEVO ---
         }
     }
 
-    // eliminar la granada (visual y objeto)
-    if (scene_) scene_->removeItem(this);
-    deleteLater();
-
-    // eliminar sprite de explosión tras un corto tiempo
-    if (expSprite) {
-        QTimer::singleShot(300, [expSprite]() {
-            if (expSprite->scene()) expSprite->scene()->removeItem(expSprite);
-            delete expSprite;
-        });
-    }
+    // la granada vuelve al pool
+    despawn();
 }
 
 
@@ -4,25 +4,37 @@
 #pragma once
 #include <QGraphicsPixmapItem>
 #include <QObject>
-#include <QSoundEffect>
+#include "GameWorld.h"
+#include "Collision.h"
+#include "ObjectPool.h"
 
-class QTimer;
 class QGraphicsScene;
 
-class ProjectileItem : public QObject, public QGraphicsPixmapItem {
+class ProjectileItem : public QObject, public QGraphicsPixmapItem, public WorldEntity {
     Q_OBJECT
 public:
-    ProjectileItem(double v0, double angleDegrees, QGraphicsScene *scene, QGraphicsItem *parent = nullptr);
+    enum { Type = ProjectileItemType };
+    int type() const override { return Type; }
+
+    // Lanza una granada desde 'pos' reciclando una del pool (nullptr si está lleno)
+    static ProjectileItem *launch(const QPointF &pos, double v0, double angleDegrees, QGraphicsScene *scene);
+    static const ObjectPool<ProjectileItem> &pool();
+    static const ObjectPool<QGraphicsPixmapItem> &explosionPool();
+
     ~ProjectileItem() override;
 
-public slots:
-    void onStep();
+    // avanzado por GameWorld en la fase de proyectiles
+    void step(double dt) override;
+    void hashState(StateHash &h) const override;
 
 private:
-    double vx; // px/s
-    double vy; // px/s (positivo hacia abajo)
+    explicit ProjectileItem(QGraphicsScene *scene, QGraphicsItem *parent = nullptr);
+    void reset(const QPointF &pos, double v0, double angleDegrees);
+    void despawn(); // dormir y volver al pool
+
+    double vx = 0.0; // px/s
+    double vy = 0.0; // px/s (positivo hacia abajo)
     const double gravity = 980.0; // px/s^2
-    QTimer *timer = nullptr;
     QGraphicsScene *scene_ = nullptr;
     double lifeTime = 10.0;
     double elapsed = 0.0;
@@ -31,11 +43,8 @@ private:
     bool exploded_ = false;
 
     void explode();
-    static QSoundEffect* explosionSound_;
-
-    // puntero estático: se inicializa nulo en tiempo de carga del módulo (no construye QPixmap)
-    static QPixmap *explosionPixmapPtr_;
-
+    // Primer instante del paso en que el arco toca algo; false si no toca nada
+    bool firstImpact(double dt, double *tHit) const;
 };
 
 
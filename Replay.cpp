@@ -0,0 +1,135 @@
+#include "Replay.h"
+#include <QDataStream>
+#include <QFile>
+#include <cstring>
+
+static const char kMagic[4] = { 'P', 'F', 'R', 'P' };
+static const quint8 kVersion = 1;
+
+// Enteros sin signo en 7 bits por byte (los tramos suelen caber en uno o dos)
+static void writeVarint(QDataStream &out, quint32 v)
+{
+    while (v >= 0x80) {
+        out << quint8((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    out << quint8(v);
+}
+
+static bool readVarint(QDataStream &in, quint32 &v)
+{
+    v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        quint8 b = 0;
+        in >> b;
+        if (in.status() != QDataStream::Ok) return false;
+        v |= quint32(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+void Replay::begin(int level, quint64 seed, int ticksPerSecond)
+{
+    level_ = level;
+    seed_ = seed;
+    ticksPerSecond_ = ticksPerSecond;
+    frames_.clear();
+    hashes_.clear();
+}
+
+void Replay::record(const InputFrame &in, quint32 stateHash)
+{
+    frames_.append(in);
+    hashes_.append(stateHash);
+}
+
+bool Replay::save(const QString &path, QString *error) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    // agrupar ticks consecutivos con la misma entrada
+    QVector<QPair<quint32, InputFrame>> runs;
+    for (const InputFrame &f : frames_) {
+        if (!runs.isEmpty() && runs.last().second == f) ++runs.last().first;
+        else runs.append(qMakePair(quint32(1), f));
+    }
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.writeRawData(kMagic, sizeof(kMagic));
+    out << kVersion << quint8(level_) << quint16(ticksPerSecond_) << quint64(seed_)
+        << quint32(frames_.size());
+
+    out << quint32(runs.size());
+    for (const auto &r : runs) {
+        writeVarint(out, r.first);
+        out << r.second.held << r.second.pressed;
+    }
+    for (quint32 h : hashes_) out << h;
+
+    if (out.status() != QDataStream::Ok) {
+        if (error) *error = QStringLiteral("error de escritura");
+        return false;
+    }
+    return true;
+}
+
+bool Replay::load(const QString &path, QString *error)
+{
+    auto fail = [error](const QString &msg) {
+        if (error) *error = msg;
+        return false;
+    };
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return fail(file.errorString());
+
+    QDataStream in(&file);
+    in.setByteOrder(QDataStream::LittleEndian);
+
+    char magic[4];
+    if (in.readRawData(magic, sizeof(magic)) != sizeof(magic)
+        || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        return fail(QStringLiteral("no es un archivo de repetición"));
+    }
+
+    quint8 version = 0, level = 0;
+    quint16 tps = 0;
+    quint64 seed = 0;
+    quint32 ticks = 0, runCount = 0;
+    in >> version >> level >> tps >> seed >> ticks >> runCount;
+    if (in.status() != QDataStream::Ok) return fail(QStringLiteral("cabecera incompleta"));
+    if (version != kVersion) return fail(QStringLiteral("versión %1 no soportada").arg(version));
+    // cada tick ocupa al menos 4 bytes (su hash): descarta tamaños absurdos
+    if (qint64(ticks) * 4 > file.size()) return fail(QStringLiteral("archivo truncado"));
+
+    QVector<InputFrame> frames;
+    frames.reserve(int(ticks));
+    for (quint32 r = 0; r < runCount; ++r) {
+        quint32 len = 0;
+        InputFrame f;
+        if (!readVarint(in, len)) return fail(QStringLiteral("tramo %1 ilegible").arg(r));
+        in >> f.held >> f.pressed;
+        if (in.status() != QDataStream::Ok || len > ticks - quint32(frames.size())) {
+            return fail(QStringLiteral("tramo %1 ilegible").arg(r));
+        }
+        frames.insert(frames.size(), int(len), f);
+    }
+    if (quint32(frames.size()) != ticks) return fail(QStringLiteral("faltan ticks de entrada"));
+
+    QVector<quint32> hashes(int(ticks));
+    for (quint32 &h : hashes) in >> h;
+    if (in.status() != QDataStream::Ok) return fail(QStringLiteral("faltan hashes"));
+
+    level_ = level;
+    seed_ = seed;
+    ticksPerSecond_ = tps;
+    frames_ = std::move(frames);
+    hashes_ = std::move(hashes);
+    return true;
+}
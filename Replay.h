@@ -0,0 +1,66 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#pragma once
+#include <QString>
+#include <QVector>
+
+// Botones lógicos del juego (no teclas físicas): GameWindow traduce el
+// teclado a esto y la simulación sólo ve estos bits, tick a tick.
+enum InputButton : quint8 {
+    BtnLeft    = 1 << 0,
+    BtnRight   = 1 << 1,
+    BtnUp      = 1 << 2,   // saltar (nivel 1) / subir (nivel 2)
+    BtnDown    = 1 << 3,   // agacharse (nivel 1) / bajar (nivel 2)
+    BtnFire    = 1 << 4,
+    BtnSwitch  = 1 << 5,   // cambiar arma
+    BtnRestart = 1 << 6    // "Reintentar" tras Game Over
+};
+
+// Entrada de un tick: qué está apretado y qué se apretó desde el tick
+// anterior (así un toque más corto que un tick no se pierde).
+struct InputFrame {
+    quint8 held = 0;
+    quint8 pressed = 0;
+
+    bool operator==(const InputFrame &o) const { return held == o.held && pressed == o.pressed; }
+    bool operator!=(const InputFrame &o) const { return !(*this == o); }
+};
+
+// Repetición de una partida: nivel inicial, semilla del mundo, la entrada de
+// cada tick y el hash del estado tras cada tick.
+//
+// En disco (little endian):
+//   "PFRP" | u8 versión | u8 nivel | u16 ticks/s | u64 semilla | u32 ticks
+//   u32 tramos, y por tramo: varint largo | u8 held | u8 pressed
+//   u32 hash por tick
+// La entrada cambia poco, así que va comprimida por tramos iguales.
+class Replay {
+public:
+    // --- Grabar ---
+    void begin(int level, quint64 seed, int ticksPerSecond);
+    void record(const InputFrame &in, quint32 stateHash);
+    bool save(const QString &path, QString *error = nullptr) const;
+
+    // --- Reproducir ---
+    bool load(const QString &path, QString *error = nullptr);
+
+    int level() const { return level_; }
+    quint64 seed() const { return seed_; }
+    int ticksPerSecond() const { return ticksPerSecond_; }
+    int frameCount() const { return frames_.size(); }
+    InputFrame frame(int tick) const { return frames_.value(tick); }
+    quint32 hash(int tick) const { return hashes_.value(tick); }
+
+    // Reduce el hash de 64 bits del mundo a los 32 que se guardan
+    static quint32 foldHash(quint64 h) { return quint32(h ^ (h >> 32)); }
+
+private:
+    int level_ = 1;
+    quint64 seed_ = 0;
+    int ticksPerSecond_ = 60;
+    QVector<InputFrame> frames_;   // en memoria, uno por tick
+    QVector<quint32> hashes_;
+};
+
+#endif // REPLAY_H
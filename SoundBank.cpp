@@ -0,0 +1,81 @@
+#include "SoundBank.h"
+#include <cstring>
+
+using namespace soundbank;
+
+bool SoundBank::open(const QString &path, QString *error)
+{
+    auto fail = [this, error](const QString &msg) {
+        if (error) *error = msg;
+        base_ = nullptr;
+        size_ = 0;
+        count_ = 0;
+        return false;
+    };
+
+    file_.close();
+    copy_.clear();
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::ReadOnly)) return fail(file_.errorString());
+
+    // mapeado (también dentro de un .qrc si el recurso va sin comprimir)
+    size_ = file_.size();
+    base_ = file_.map(0, size_);
+    mapped_ = base_ != nullptr;
+    if (!mapped_) {
+        copy_ = file_.readAll();
+        base_ = reinterpret_cast<const uchar*>(copy_.constData());
+        size_ = copy_.size();
+    }
+
+    if (size_ < qint64(sizeof(BankHeader))) return fail(QStringLiteral("banco truncado"));
+    BankHeader h;
+    std::memcpy(&h, base_, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) return fail(QStringLiteral("no es un banco de sonidos"));
+    if (h.version != kVersion) return fail(QStringLiteral("versión %1 no soportada").arg(h.version));
+    if (h.sampleRate == 0) return fail(QStringLiteral("frecuencia inválida"));
+    if (qint64(sizeof(BankHeader)) + qint64(h.count) * qint64(sizeof(BankEntry)) > size_)
+        return fail(QStringLiteral("tabla de clips truncada"));
+
+    // cada clip tiene que caber en el archivo y traer todas sus muestras
+    for (int i = 0; i < h.count; ++i) {
+        BankEntry e;
+        std::memcpy(&e, base_ + sizeof(BankHeader) + i * sizeof(BankEntry), sizeof(e));
+        if (qint64(e.offset) + qint64(e.size) > size_) return fail(QStringLiteral("clip %1 fuera del banco").arg(i));
+
+        qint64 needed = 0;
+        if (e.codec == Pcm16) {
+            needed = qint64(e.frames) * 2;
+        } else if (e.codec == ImaAdpcm) {
+            if (e.frames > 0) {
+                const qint64 blocks = (qint64(e.frames) + kAdpcmBlockSamples - 1) / kAdpcmBlockSamples;
+                const qint64 tail = e.frames - (blocks - 1) * kAdpcmBlockSamples;
+                needed = (blocks - 1) * kAdpcmBlockBytes + 4 + tail / 2;
+            }
+        } else {
+            return fail(QStringLiteral("clip %1: códec %2 desconocido").arg(i).arg(e.codec));
+        }
+        if (qint64(e.size) < needed) return fail(QStringLiteral("clip %1 incompleto").arg(i));
+    }
+
+    rate_ = int(h.sampleRate);
+    count_ = h.count;
+    return true;
+}
+
+SoundBank::Clip SoundBank::clip(const char *name) const
+{
+    Clip c;
+    for (int i = 0; i < count_; ++i) {
+        BankEntry e;
+        std::memcpy(&e, base_ + sizeof(BankHeader) + i * sizeof(BankEntry), sizeof(e));
+        if (qstrncmp(e.name, name, sizeof(e.name)) != 0) continue;
+
+        c.data = base_ + e.offset;
+        c.size = e.size;
+        c.frames = e.frames;
+        c.codec = e.codec;
+        break;
+    }
+    return c;
+}
@@ -0,0 +1,89 @@
+#ifndef SOUNDBANK_H
+#define SOUNDBANK_H
+
+#pragma once
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QtEndian>
+#include "SoundBankFormat.h"
+
+// Banco de efectos ya normalizados (mono, una sola frecuencia) que arma
+// tools/soundbank. Se abre una vez y se usa mapeado: los clips se leen de
+// ahí directamente, el IMA-ADPCM se decodifica al vuelo en cada voz y no
+// queda ningún PCM decodificado en memoria.
+class SoundBank {
+public:
+    struct Clip {
+        const uchar *data = nullptr;
+        quint32 size = 0;
+        quint32 frames = 0;
+        quint8 codec = soundbank::Pcm16;
+
+        bool isNull() const { return !data || frames == 0; }
+    };
+
+    // Lectura secuencial de un clip, muestra a muestra (una por voz)
+    class Cursor {
+    public:
+        void reset(const Clip &clip)
+        {
+            clip_ = clip;
+            pos_ = 0;
+            block_ = clip.data;
+            inBlock_ = 0;
+            state_ = soundbank::AdpcmState();
+        }
+
+        bool atEnd() const { return pos_ >= clip_.frames; }
+        quint32 position() const { return pos_; }
+
+        qint16 next()
+        {
+            const quint32 i = pos_++;
+            if (clip_.codec == soundbank::Pcm16) return qFromLittleEndian<qint16>(clip_.data + i * 2);
+
+            // cada bloque ADPCM empieza con la muestra entera y su índice de paso
+            if (inBlock_ == 0) {
+                state_.predictor = qFromLittleEndian<qint16>(block_);
+                state_.index = qMin<int>(block_[2], 88);
+                inBlock_ = 1;
+                return qint16(state_.predictor);
+            }
+            const int k = inBlock_ - 1;
+            const int byte = block_[4 + (k >> 1)];
+            const qint16 v = soundbank::decodeNibble(state_, (k & 1) ? byte >> 4 : byte & 0x0F);
+            if (++inBlock_ == soundbank::kAdpcmBlockSamples) {
+                inBlock_ = 0;
+                block_ += soundbank::kAdpcmBlockBytes;
+            }
+            return v;
+        }
+
+    private:
+        Clip clip_;
+        quint32 pos_ = 0;
+        const uchar *block_ = nullptr;
+        int inBlock_ = 0;
+        soundbank::AdpcmState state_;
+    };
+
+    bool open(const QString &path, QString *error = nullptr);
+
+    Clip clip(const char *name) const;   // nulo si no está
+    int sampleRate() const { return rate_; }
+    int clipCount() const { return count_; }
+    qint64 bytes() const { return size_; }
+    bool isMapped() const { return mapped_; }
+
+private:
+    QFile file_;
+    QByteArray copy_;          // sólo si el archivo no se pudo mapear
+    const uchar *base_ = nullptr;
+    qint64 size_ = 0;
+    int rate_ = 0;
+    int count_ = 0;
+    bool mapped_ = false;
+};
+
+#endif // SOUNDBANK_H
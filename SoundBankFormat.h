@@ -0,0 +1,112 @@
+#ifndef SOUNDBANKFORMAT_H
+#define SOUNDBANKFORMAT_H
+
+#pragma once
+#include <cstdint>
+
+// Formato del banco de efectos (sounds/efectos.bank). Lo escribe la
+// herramienta tools/soundbank y lo lee SoundBank; va sin Qt para que la
+// herramienta compile sola con cualquier compilador C++17.
+//
+// Little endian, alineado a 4, pensado para usarse mapeado tal cual:
+//   BankHeader | BankEntry × count | datos de cada clip
+// Todos los clips son mono a BankHeader::sampleRate, en PCM de 16 bits o en
+// IMA-ADPCM por bloques de kAdpcmBlockBytes: cabecera de 4 bytes (muestra
+// inicial s16, índice de paso u8, 0) y luego dos muestras por byte, primero
+// el nibble bajo. El último bloque puede venir incompleto.
+namespace soundbank {
+
+constexpr char kMagic[4] = { 'P', 'F', 'S', 'B' };
+constexpr uint16_t kVersion = 1;
+constexpr uint32_t kDefaultRate = 22050;
+constexpr int kAdpcmBlockBytes = 256;
+constexpr int kAdpcmBlockSamples = (kAdpcmBlockBytes - 4) * 2 + 1;   // 505
+
+enum Codec : uint8_t {
+    Pcm16 = 0,
+    ImaAdpcm = 1
+};
+
+struct BankHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t count;
+    uint32_t sampleRate;
+    uint32_t reserved;
+};
+
+struct BankEntry {
+    char name[24];          // terminado en 0
+    uint8_t codec;
+    uint8_t reserved[3];
+    uint32_t frames;
+    uint32_t offset;        // desde el principio del archivo
+    uint32_t size;
+};
+
+static_assert(sizeof(BankHeader) == 16, "BankHeader cambió de tamaño");
+static_assert(sizeof(BankEntry) == 40, "BankEntry cambió de tamaño");
+
+// ----------------------------
+// IMA-ADPCM (4 bits por muestra)
+// ----------------------------
+constexpr int16_t kStepTable[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+    34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143,
+    157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024,
+    3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+constexpr int8_t kIndexTable[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+struct AdpcmState {
+    int predictor = 0;
+    int index = 0;
+};
+
+inline int16_t decodeNibble(AdpcmState &s, int nibble)
+{
+    const int step = kStepTable[s.index];
+    int diff = step >> 3;
+    if (nibble & 4) diff += step;
+    if (nibble & 2) diff += step >> 1;
+    if (nibble & 1) diff += step >> 2;
+
+    s.predictor += (nibble & 8) ? -diff : diff;
+    if (s.predictor > 32767) s.predictor = 32767;
+    else if (s.predictor < -32768) s.predictor = -32768;
+
+    s.index += kIndexTable[nibble & 15];
+    if (s.index < 0) s.index = 0;
+    else if (s.index > 88) s.index = 88;
+    return int16_t(s.predictor);
+}
+
+// Devuelve el nibble y deja 's' igual que lo dejará el decodificador
+inline int encodeSample(AdpcmState &s, int sample)
+{
+    int diff = sample - s.predictor;
+    int nibble = 0;
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+    int step = kStepTable[s.index];
+    if (diff >= step) { nibble |= 4; diff -= step; }
+    step >>= 1;
+    if (diff >= step) { nibble |= 2; diff -= step; }
+    step >>= 1;
+    if (diff >= step) nibble |= 1;
+
+    decodeNibble(s, nibble);
+    return nibble;
+}
+
+} // namespace soundbank
+
+#endif // SOUNDBANKFORMAT_H
@@ -0,0 +1,202 @@
+#include "SpatialHash.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+// Misma elección de núcleo que BulletSystem: sólo operaciones con redondeo
+// exacto (sin FMA), así el resultado no depende de con qué se compile
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define SPATIAL_SSE2 1
+#endif
+
+void SpatialHash::setBounds(const QRectF &bounds, qreal cellSize)
+{
+    bounds_ = bounds;
+    cell_ = qMax<qreal>(8.0, cellSize);
+    cols_ = qMax(1, qCeil(bounds.width() / cell_));
+    rows_ = qMax(1, qCeil(bounds.height() / cell_));
+    reset();
+}
+
+void SpatialHash::reset()
+{
+    entries_.clear();
+    cellItems_.clear();
+    cellStart_.fill(0, cols_ * rows_ + 1);
+}
+
+void SpatialHash::cellRange(const QRectF &r, int &x0, int &y0, int &x1, int &y1) const
+{
+    // lo que cae fuera de la escena se queda en las celdas del borde
+    x0 = qBound(0, int(std::floor((r.left() - bounds_.left()) / cell_)), cols_ - 1);
+    y0 = qBound(0, int(std::floor((r.top() - bounds_.top()) / cell_)), rows_ - 1);
+    x1 = qBound(0, int(std::floor((r.right() - bounds_.left()) / cell_)), cols_ - 1);
+    y1 = qBound(0, int(std::floor((r.bottom() - bounds_.top()) / cell_)), rows_ - 1);
+}
+
+void SpatialHash::beginBuild()
+{
+    // cerrar las estadísticas del tick anterior
+    cur_.totalCandidates += cur_.candidates;
+    last_ = cur_;
+    const quint64 total = cur_.totalCandidates;
+    cur_ = Stats();
+    cur_.totalCandidates = total;
+
+    entries_.clear();
+}
+
+int SpatialHash::add(QGraphicsItem *item, CollisionCategory category)
+{
+    Entry e;
+    e.item = item;
+    e.box = item->sceneBoundingRect();
+    e.category = category;
+    e.stamp = 0;
+    cellRange(e.box, e.x0, e.y0, e.x1, e.y1);
+    entries_.append(e);
+    return entries_.size() - 1;
+}
+
+void SpatialHash::endBuild()
+{
+    const int cellCount = cols_ * rows_;
+    cellStart_.fill(0, cellCount + 1);
+
+    // 1) contar por celda
+    for (const Entry &e : entries_) {
+        for (int cy = e.y0; cy <= e.y1; ++cy)
+            for (int cx = e.x0; cx <= e.x1; ++cx)
+                ++cellStart_[cy * cols_ + cx + 1];
+    }
+
+    // 2) prefijos -> inicio de cada celda
+    for (int c = 0; c < cellCount; ++c) {
+        const int n = cellStart_[c + 1];
+        if (n > 0) {
+            ++cur_.occupiedCells;
+            cur_.maxPerCell = qMax(cur_.maxPerCell, n);
+        }
+        cellStart_[c + 1] += cellStart_[c];
+    }
+
+    // 3) repartir
+    cellItems_.resize(cellStart_[cellCount]);
+    QVector<int> fill(cellStart_.begin(), cellStart_.end() - 1);
+    for (int i = 0; i < entries_.size(); ++i) {
+        const Entry &e = entries_[i];
+        for (int cy = e.y0; cy <= e.y1; ++cy)
+            for (int cx = e.x0; cx <= e.x1; ++cx)
+                cellItems_[fill[cy * cols_ + cx]++] = i;
+    }
+
+    cur_.colliders = entries_.size();
+}
+
+void SpatialHash::disable(int slot)
+{
+    if (slot >= 0 && slot < entries_.size()) entries_[slot].item = nullptr;
+}
+
+void SpatialHash::collect(const QRectF &area, quint32 categoryMask, QVarLengthArray<int, 16> &slots)
+{
+    ++cur_.queries;
+    if (entries_.isEmpty()) return;
+
+    // sello para no devolver dos veces un item que ocupa varias celdas
+    if (++stamp_ == 0) {
+        for (Entry &e : entries_) e.stamp = 0;
+        stamp_ = 1;
+    }
+
+    int x0, y0, x1, y1;
+    cellRange(area, x0, y0, x1, y1);
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            const int c = cy * cols_ + cx;
+            for (int k = cellStart_[c]; k < cellStart_[c + 1]; ++k) {
+                Entry &e = entries_[cellItems_[k]];
+                if (e.stamp == stamp_) continue;
+                e.stamp = stamp_;
+
+                if (!e.item || !(categoryMask & categoryBit(e.category))) continue;
+                if (!e.box.intersects(area)) continue;
+
+                ++cur_.candidates;
+                slots.append(cellItems_[k]);
+            }
+        }
+    }
+}
+
+void SpatialHash::query(const QRectF &area, quint32 categoryMask, Candidates &out)
+{
+    QVarLengthArray<int, 16> slots;
+    collect(area, categoryMask, slots);
+    for (int slot : slots) out.append(entries_[slot].item);
+}
+
+// Distancia de (cx, cy) a cada caja y atenuación 1 - d/r (0 fuera del radio)
+static void radialFalloff(const float *left, const float *top, const float *right, const float *bottom,
+                          int n, float cx, float cy, float radius, float *dist, float *falloff)
+{
+    int i = 0;
+#ifdef SPATIAL_SSE2
+    const __m128 x4 = _mm_set1_ps(cx), y4 = _mm_set1_ps(cy);
+    const __m128 r4 = _mm_set1_ps(radius), one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        // lo que falta para llegar a la caja en cada eje (0 si está dentro)
+        const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(left + i), x4),
+                                                _mm_sub_ps(x4, _mm_loadu_ps(right + i))), zero);
+        const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(top + i), y4),
+                                                _mm_sub_ps(y4, _mm_loadu_ps(bottom + i))), zero);
+        const __m128 d = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        _mm_storeu_ps(dist + i, d);
+        _mm_storeu_ps(falloff + i, _mm_max_ps(_mm_sub_ps(one, _mm_div_ps(d, r4)), zero));
+    }
+#endif
+    // resto (o todo, sin SIMD)
+    for (; i < n; ++i) {
+        const float dx = std::max(std::max(left[i] - cx, cx - right[i]), 0.0f);
+        const float dy = std::max(std::max(top[i] - cy, cy - bottom[i]), 0.0f);
+        const float dxx = dx * dx;
+        const float dyy = dy * dy;
+        dist[i] = std::sqrt(dxx + dyy);
+        falloff[i] = std::max(1.0f - dist[i] / radius, 0.0f);
+    }
+}
+
+void SpatialHash::queryRadius(const QPointF &center, qreal radius, quint32 categoryMask, RadialHits &out)
+{
+    if (radius <= 0.0) return;
+    QVarLengthArray<int, 16> slots;
+    collect(QRectF(center.x() - radius, center.y() - radius, 2 * radius, 2 * radius), categoryMask, slots);
+    const int n = slots.size();
+    if (n == 0) return;
+
+    // columnas para la pasada vectorizada
+    QVarLengthArray<float, 16> left(n), top(n), right(n), bottom(n), dist(n), falloff(n);
+    for (int k = 0; k < n; ++k) {
+        const QRectF &b = entries_[slots[k]].box;
+        left[k] = float(b.left());
+        top[k] = float(b.top());
+        right[k] = float(b.right());
+        bottom[k] = float(b.bottom());
+    }
+    radialFalloff(left.data(), top.data(), right.data(), bottom.data(), n,
+                  float(center.x()), float(center.y()), float(radius), dist.data(), falloff.data());
+
+    for (int k = 0; k < n; ++k) {
+        if (falloff[k] <= 0.0f) continue;
+        const Entry &e = entries_[slots[k]];
+        out.append({ e.item, e.category, e.box, dist[k], falloff[k] });
+    }
+}
+
+int SpatialHash::cellOccupancy(int cx, int cy) const
+{
+    const int c = cy * cols_ + cx;
+    if (c < 0 || c + 1 >= cellStart_.size()) return 0;
+    return cellStart_[c + 1] - cellStart_[c];
+}
@@ -0,0 +1,95 @@
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+#pragma once
+#include <QRectF>
+#include <QVarLengthArray>
+#include <QVector>
+#include "Collision.h"
+
+// Broadphase de colisiones: rejilla uniforme sobre el rect de la escena.
+// Se reconstruye entera una vez por tick (GameWorld, tras mover a los
+// actores) y las balas/llamas/explosiones le piden candidatos en vez de
+// usar collidingItems() sobre el índice BSP de la escena.
+//
+// Las celdas se guardan compactas (CSR): cellStart_[c]..cellStart_[c+1]
+// son las posiciones de cellItems_ que pertenecen a la celda c.
+class SpatialHash {
+public:
+    using Candidates = QVarLengthArray<QGraphicsItem*, 16>;
+
+    // Resultado de queryRadius(): el item, su caja de este tick y cuánto le
+    // llega (1 en el centro, 0 en el borde del radio)
+    struct RadialHit {
+        QGraphicsItem *item;
+        CollisionCategory category;
+        QRectF box;
+        float distance;           // del centro al punto más cercano de la caja
+        float falloff;            // 1 - distance / radius
+    };
+    using RadialHits = QVarLengthArray<RadialHit, 16>;
+
+    struct Stats {
+        int colliders = 0;
+        int occupiedCells = 0;
+        int maxPerCell = 0;
+        int queries = 0;          // consultas en el último tick
+        int candidates = 0;       // pares candidato devueltos en el último tick
+        quint64 totalCandidates = 0;
+    };
+
+    void setBounds(const QRectF &bounds, qreal cellSize = 64.0);
+    QRectF bounds() const { return bounds_; }
+    qreal cellSize() const { return cell_; }
+    int columns() const { return cols_; }
+    int rows() const { return rows_; }
+
+    // Reconstrucción: beginBuild(), add() por cada collider, endBuild()
+    void beginBuild();
+    int add(QGraphicsItem *item, CollisionCategory category); // devuelve el slot
+    void endBuild();
+
+    // El item del slot dejó el mundo a mitad de tick: ya no se devuelve
+    void disable(int slot);
+    void reset();
+
+    // Items cuya caja toca 'area' y cuya categoría está en 'categoryMask'
+    // (cada uno una sola vez). La prueba exacta de forma la hace quien pregunta.
+    void query(const QRectF &area, quint32 categoryMask, Candidates &out);
+
+    // Efectos de área: items de 'categoryMask' cuya caja queda a menos de
+    // 'radius' de 'center' (distancia a la caja, no a pos()). Distancias y
+    // atenuación se calculan en una pasada vectorizada sobre los candidatos.
+    void queryRadius(const QPointF &center, qreal radius, quint32 categoryMask, RadialHits &out);
+
+    int cellOccupancy(int cx, int cy) const;
+    const Stats &stats() const { return last_; }
+
+private:
+    struct Entry {
+        QGraphicsItem *item;
+        QRectF box;
+        CollisionCategory category;
+        int x0, y0, x1, y1;       // celdas que ocupa (inclusive)
+        quint32 stamp;            // última consulta que lo devolvió
+    };
+
+    void cellRange(const QRectF &r, int &x0, int &y0, int &x1, int &y1) const;
+    // índices en entries_ de lo que devuelve una consulta sobre 'area'
+    void collect(const QRectF &area, quint32 categoryMask, QVarLengthArray<int, 16> &slots);
+
+    QRectF bounds_;
+    qreal cell_ = 64.0;
+    int cols_ = 1;
+    int rows_ = 1;
+
+    QVector<Entry> entries_;
+    QVector<int> cellStart_;
+    QVector<int> cellItems_;
+    quint32 stamp_ = 0;
+
+    Stats cur_;   // tick en curso
+    Stats last_;  // último tick completo (overlay / resumen)
+};
+
+#endif // SPATIALHASH_H
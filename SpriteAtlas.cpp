@@ -0,0 +1,97 @@
+#include "SpriteAtlas.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+static const char *kIndexPath = ":/cooked/sprites.idx";
+
+const SpriteAtlas &SpriteAtlas::instance()
+{
+    static const SpriteAtlas atlas = [] {
+        SpriteAtlas a;
+        QString error;
+        // sin cocinar no hay índice y no es un error
+        if (QFile::exists(QString::fromLatin1(kIndexPath)) && !a.load(QString::fromLatin1(kIndexPath), &error))
+            qWarning() << "SpriteAtlas:" << error;
+        return a;
+    }();
+    return atlas;
+}
+
+bool SpriteAtlas::load(const QString &indexPath, QString *error)
+{
+    pages_.clear();
+    entries_.clear();
+
+    auto fail = [this, error](const QString &msg) {
+        if (error) *error = msg;
+        pages_.clear();
+        entries_.clear();
+        return false;
+    };
+
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return fail(file.errorString());
+
+    // las páginas van al lado del índice
+    const QString dir = QFileInfo(indexPath).path() + QLatin1Char('/');
+    QTextStream in(&file);
+    bool header = false;
+    int lineNo = 0;
+    while (!in.atEnd()) {
+        ++lineNo;
+        const QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#'))) continue;
+        auto bad = [&](const char *why) {
+            return fail(QStringLiteral("%1:%2: %3").arg(indexPath).arg(lineNo).arg(QLatin1String(why)));
+        };
+
+        if (!header) {
+            if (line != QLatin1String("assetcook 1")) return bad("versión no soportada");
+            header = true;
+            continue;
+        }
+
+        if (line.startsWith(QLatin1String("page "))) {
+            const QStringList t = line.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+            if (t.size() != 3 || t[1].toInt() != pages_.size()) return bad("página inválida");
+            pages_.append(dir + t[2]);
+        } else if (line.startsWith(QLatin1String("sprite "))) {
+            // diez campos; la ruta es el resto de la línea
+            const QStringList t = line.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+            if (t.size() < 11) return bad("sprite incompleto");
+            int v[7];
+            for (int i = 0; i < 7; ++i) {
+                bool ok = false;
+                v[i] = t[i + 1].toInt(&ok);
+                if (!ok) return bad("número inválido");
+            }
+            Entry e;
+            e.page = v[0];
+            e.rect = QRect(v[1], v[2], v[3], v[4]);
+            e.size = v[5] < 0 ? QSize() : QSize(v[5], v[6]);
+            e.mode = t[8] == QLatin1String("keep") ? Qt::KeepAspectRatio : Qt::IgnoreAspectRatio;
+            e.flipX = t[9] == QLatin1String("1");
+            e.path = line.section(QLatin1Char(' '), 10, -1, QString::SectionSkipEmpty);
+            if (e.page < 0 || e.page >= pages_.size() || e.rect.isEmpty()) return bad("sprite fuera de las páginas");
+            entries_.append(e);
+        } else {
+            return bad("registro desconocido");
+        }
+    }
+    if (!header) return fail(indexPath + QStringLiteral(": índice vacío"));
+    return true;
+}
+
+int SpriteAtlas::find(const QString &path, const QSize &size, Qt::AspectRatioMode mode, bool flipX) const
+{
+    // pocas decenas de entradas y sólo se consulta al fallar la caché
+    const QSize key = size.isValid() ? size : QSize();
+    for (int i = 0; i < entries_.size(); ++i) {
+        const Entry &e = entries_[i];
+        if (e.flipX == flipX && e.mode == mode && e.size == key && e.path == path)
+            return i;
+    }
+    return -1;
+}
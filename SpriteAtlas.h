@@ -0,0 +1,51 @@
+#ifndef SPRITEATLAS_H
+#define SPRITEATLAS_H
+
+#pragma once
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Índice de los atlas que arma tools/assetcook (CONFIG+=cooked_sprites):
+// para cada variante que pide el juego, en qué página y en qué rectángulo
+// quedó, ya escalada y espejada. Sin cocinar el índice está vacío y
+// SpriteCache escala los PNG originales como siempre.
+//
+// Formato (texto, una línea por registro, '#' comenta):
+//   assetcook 1
+//   page <n> <archivo>
+//   sprite <página> <x> <y> <ancho> <alto> <ancho pedido> <alto pedido> keep|ignore 0|1 <ruta>
+// Tamaño pedido -1 -1 = tamaño original. La ruta es la misma que se le pasa
+// a SpriteCache::get.
+class SpriteAtlas {
+public:
+    struct Entry {
+        QString path;
+        QSize size;                 // el pedido (clave de SpriteCache), no el final
+        Qt::AspectRatioMode mode = Qt::IgnoreAspectRatio;
+        bool flipX = false;
+        int page = 0;
+        QRect rect;
+    };
+
+    // El de los recursos (":/cooked/sprites.idx"), leído la primera vez
+    static const SpriteAtlas &instance();
+
+    bool load(const QString &indexPath, QString *error = nullptr);
+
+    bool isEmpty() const { return entries_.isEmpty(); }
+    int pageCount() const { return pages_.size(); }
+    QString pagePath(int page) const { return pages_.value(page); }
+    const QVector<Entry> &entries() const { return entries_; }
+
+    // -1 si la variante no se cocinó
+    int find(const QString &path, const QSize &size, Qt::AspectRatioMode mode, bool flipX) const;
+
+private:
+    QStringList pages_;             // rutas completas, por número de página
+    QVector<Entry> entries_;
+};
+
+#endif // SPRITEATLAS_H
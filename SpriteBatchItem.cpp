@@ -0,0 +1,127 @@
+#include "SpriteBatchItem.h"
+#include <QGraphicsScene>
+#include <QtMath>
+
+SpriteBatchItem::SpriteBatchItem(const QPixmap &pixmap, QGraphicsItem *parent)
+    : QGraphicsItem(parent), pixmap_(pixmap)
+{
+    radius_ = 0.5 * std::hypot(qreal(pixmap_.width()), qreal(pixmap_.height()));
+    setAcceptedMouseButtons(Qt::NoButton);
+}
+
+int SpriteBatchItem::addInstance(const QPointF &pos, qreal rotation, qreal opacity)
+{
+    int handle;
+    if (!freeHandles_.isEmpty()) {
+        handle = freeHandles_.takeLast();
+    } else {
+        handle = indexOf_.size();
+        indexOf_.append(-1);
+    }
+
+    indexOf_[handle] = fragments_.size();
+    handleOf_.append(handle);
+    fragments_.append(QPainter::PixmapFragment::create(pos, pixmap_.rect(), 1.0, 1.0, rotation, opacity));
+    dirty_ = true;
+    return handle;
+}
+
+void SpriteBatchItem::setInstance(int handle, const QPointF &pos, qreal rotation, qreal opacity)
+{
+    if (handle < 0 || handle >= indexOf_.size() || indexOf_[handle] < 0) return;
+    QPainter::PixmapFragment &f = fragments_[indexOf_[handle]];
+    f.x = pos.x();
+    f.y = pos.y();
+    f.rotation = rotation;
+    f.opacity = opacity;
+    dirty_ = true;
+}
+
+void SpriteBatchItem::removeInstance(int handle)
+{
+    if (handle < 0 || handle >= indexOf_.size() || indexOf_[handle] < 0) return;
+
+    // el último ocupa el hueco: las instancias siguen contiguas
+    const int idx = indexOf_[handle];
+    const int last = fragments_.size() - 1;
+    if (idx != last) {
+        fragments_[idx] = fragments_[last];
+        handleOf_[idx] = handleOf_[last];
+        indexOf_[handleOf_[idx]] = idx;
+    }
+    fragments_.removeLast();
+    handleOf_.removeLast();
+    indexOf_[handle] = -1;
+    freeHandles_.append(handle);
+    dirty_ = true;
+}
+
+void SpriteBatchItem::flush()
+{
+    if (!dirty_) return;
+    dirty_ = false;
+
+    QRectF b;
+    if (!fragments_.isEmpty()) {
+        qreal x0 = fragments_[0].x, x1 = x0, y0 = fragments_[0].y, y1 = y0;
+        for (const QPainter::PixmapFragment &f : fragments_) {
+            x0 = qMin(x0, f.x); x1 = qMax(x1, f.x);
+            y0 = qMin(y0, f.y); y1 = qMax(y1, f.y);
+        }
+        b = QRectF(QPointF(x0, y0), QPointF(x1, y1)).adjusted(-radius_, -radius_, radius_, radius_);
+    }
+
+    if (b != bounds_) {
+        prepareGeometryChange();
+        bounds_ = b;
+    }
+    update();
+}
+
+void SpriteBatchItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    if (fragments_.isEmpty() || pixmap_.isNull()) return;
+    painter->drawPixmapFragments(fragments_.constData(), fragments_.size(), pixmap_);
+}
+
+// ----------------------------
+// SpriteBatches
+// ----------------------------
+void SpriteBatches::setScene(QGraphicsScene *scene)
+{
+    if (scene_ == scene) return;
+    clear();
+    scene_ = scene;
+}
+
+SpriteBatchItem *SpriteBatches::batchFor(const QPixmap &pixmap, qreal z)
+{
+    if (!scene_) return nullptr;
+
+    SpriteBatchItem *&batch = batches_[pixmap.cacheKey()];
+    if (!batch) {
+        batch = new SpriteBatchItem(pixmap);
+        batch->setZValue(z);
+        scene_->addItem(batch);
+    }
+    return batch;
+}
+
+void SpriteBatches::flush()
+{
+    for (SpriteBatchItem *b : std::as_const(batches_)) b->flush();
+}
+
+void SpriteBatches::clear()
+{
+    batches_.clear();
+}
+
+int SpriteBatches::instanceCount() const
+{
+    int n = 0;
+    for (SpriteBatchItem *b : batches_) n += b->instanceCount();
+    return n;
+}
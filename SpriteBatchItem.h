@@ -0,0 +1,69 @@
+#ifndef SPRITEBATCHITEM_H
+#define SPRITEBATCHITEM_H
+
+#pragma once
+#include <QGraphicsItem>
+#include <QHash>
+#include <QPainter>
+#include <QPixmap>
+#include <QVector>
+#include "Collision.h"
+
+// Muchas copias de un mismo sprite (p.ej. todas las balas enemigas) en un
+// solo item de la escena: un paint() con QPainter::drawPixmapFragments en
+// vez de un QGraphicsItem por copia. Cada instancia tiene posición (centro,
+// en coordenadas de escena), rotación en grados y opacidad.
+//
+// Los handles son estables; internamente las instancias van compactas.
+// Tras mover instancias hay que llamar a flush() antes de pintar.
+class SpriteBatchItem : public QGraphicsItem {
+public:
+    enum { Type = SpriteBatchItemType };
+    int type() const override { return Type; }
+
+    explicit SpriteBatchItem(const QPixmap &pixmap, QGraphicsItem *parent = nullptr);
+
+    int addInstance(const QPointF &pos, qreal rotation = 0.0, qreal opacity = 1.0);
+    void setInstance(int handle, const QPointF &pos, qreal rotation = 0.0, qreal opacity = 1.0);
+    void removeInstance(int handle);
+    int instanceCount() const { return fragments_.size(); }
+
+    // Recalcula la caja (si cambió) y pide repintar
+    void flush();
+
+    QRectF boundingRect() const override { return bounds_; }
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    QPixmap pixmap_;
+    qreal radius_ = 0.0;                          // medio diagonal del sprite
+    QVector<QPainter::PixmapFragment> fragments_;
+    QVector<int> handleOf_;    // índice -> handle
+    QVector<int> indexOf_;     // handle -> índice (-1 libre)
+    QVector<int> freeHandles_;
+    QRectF bounds_;
+    bool dirty_ = false;
+};
+
+// Un SpriteBatchItem por textura (cacheKey del QPixmap) en la escena del
+// nivel. Los items son de la escena: clear() sólo los olvida (reinicio).
+class SpriteBatches {
+public:
+    void setScene(QGraphicsScene *scene);
+    QGraphicsScene *scene() const { return scene_; }
+
+    // nullptr si no hay escena
+    SpriteBatchItem *batchFor(const QPixmap &pixmap, qreal z);
+
+    void flush();
+    void clear();
+
+    int batchCount() const { return batches_.size(); }
+    int instanceCount() const;
+
+private:
+    QGraphicsScene *scene_ = nullptr;
+    QHash<qint64, SpriteBatchItem*> batches_;
+};
+
+#endif // SPRITEBATCHITEM_H
@@ -0,0 +1,187 @@
+#include "SpriteCache.h"
+#include "SpriteAtlas.h"
+#include <QHash>
+#include <QImageReader>
+#include <QTransform>
+
+namespace {
+
+struct Key {
+    QString path;
+    QSize size;
+    quint8 mode;
+    bool flipX;
+
+    bool operator==(const Key &o) const
+    {
+        return path == o.path && size == o.size && mode == o.mode && flipX == o.flipX;
+    }
+};
+
+size_t qHash(const Key &k, size_t seed = 0)
+{
+    return qHashMulti(seed, k.path, k.size.width(), k.size.height(), k.mode, k.flipX);
+}
+
+struct Cache {
+    QHash<Key, QPixmap> pixmaps;
+    QPixmap byId[static_cast<int>(SpriteId::Count)];
+    bool resolved[static_cast<int>(SpriteId::Count)] = {};
+    SpriteCache::Stats stats;
+};
+
+Cache &cache()
+{
+    static Cache c;
+    return c;
+}
+
+qint64 footprint(const QPixmap &p)
+{
+    return p.isNull() ? 0 : qint64(p.width()) * p.height() * p.depth() / 8;
+}
+
+void store(Cache &c, const Key &key, const QPixmap &pix)
+{
+    c.pixmaps.insert(key, pix);
+    ++c.stats.entries;
+    c.stats.bytes += footprint(pix);
+}
+
+// Una página del atlas se decodifica una sola vez y se reparte entera: sus
+// variantes ya vienen escaladas y espejadas, y las demás se van a pedir
+// enseguida (son del mismo nivel)
+void loadAtlasPage(Cache &c, const SpriteAtlas &atlas, int page)
+{
+    const QImage img = QImageReader(atlas.pagePath(page)).read();
+    for (const SpriteAtlas::Entry &e : atlas.entries()) {
+        if (e.page != page) continue;
+        const Key k{ e.path, e.size, quint8(e.mode), e.flipX };
+        if (c.pixmaps.contains(k)) continue;
+        store(c, k, img.isNull() ? QPixmap() : QPixmap::fromImage(img.copy(e.rect)));
+    }
+}
+
+// Busca o crea la variante sin tocar las estadísticas (la base de un
+// escalado no cuenta como pedido aparte)
+QPixmap lookup(const Key &key)
+{
+    Cache &c = cache();
+    auto it = c.pixmaps.constFind(key);
+    if (it != c.pixmaps.constEnd()) return it.value();
+
+    const SpriteAtlas &atlas = SpriteAtlas::instance();
+    const int cooked = atlas.find(key.path, key.size, static_cast<Qt::AspectRatioMode>(key.mode), key.flipX);
+    if (cooked >= 0) {
+        loadAtlasPage(c, atlas, atlas.entries().at(cooked).page);
+        return c.pixmaps.value(key);
+    }
+
+    QPixmap pix;
+    if (key.flipX) {
+        Key base = key;
+        base.flipX = false;
+        const QPixmap src = lookup(base);
+        if (!src.isNull()) pix = src.transformed(QTransform().scale(-1, 1));
+    } else if (key.size.isValid() && !key.size.isEmpty()) {
+        // el original sólo se usa para escalar: no se guarda si no estaba, y
+        // si no estaba ni se llega a crear (lectura ya escalada)
+        Key base = key;
+        base.size = QSize();
+        base.mode = Qt::IgnoreAspectRatio;
+        const auto mode = static_cast<Qt::AspectRatioMode>(key.mode);
+        auto b = c.pixmaps.constFind(base);
+        if (b != c.pixmaps.constEnd()) {
+            if (!b.value().isNull()) pix = b.value().scaled(key.size, mode, Qt::SmoothTransformation);
+        } else {
+            const QImage img = SpriteCache::readScaled(key.path, key.size, mode);
+            if (!img.isNull()) pix = QPixmap::fromImage(img);
+        }
+    } else {
+        pix = QPixmap(key.path);
+    }
+
+    store(c, key, pix);
+    return pix;
+}
+
+} // namespace
+
+QPixmap SpriteCache::get(const QString &path, const QSize &size, Qt::AspectRatioMode mode, bool flipX)
+{
+    Cache &c = cache();
+    const Key key{ path, size.isValid() ? size : QSize(), quint8(mode), flipX };
+
+    auto it = c.pixmaps.constFind(key);
+    if (it != c.pixmaps.constEnd()) {
+        ++c.stats.hits;
+        return it.value();
+    }
+    ++c.stats.misses;
+    return lookup(key);
+}
+
+QPixmap SpriteCache::get(SpriteId id)
+{
+    Cache &c = cache();
+    const int i = static_cast<int>(id);
+    if (c.resolved[i]) {
+        ++c.stats.hits;
+        return c.byId[i];
+    }
+
+    const SpriteDef &def = spriteDef(id);
+    c.byId[i] = get(QString::fromLatin1(def.path), def.size(), def.mode, def.flipX);
+    c.resolved[i] = true;
+    return c.byId[i];
+}
+
+bool SpriteCache::contains(const QString &path, const QSize &size, Qt::AspectRatioMode mode, bool flipX)
+{
+    const Key key{ path, size.isValid() ? size : QSize(), quint8(mode), flipX };
+    return cache().pixmaps.contains(key);
+}
+
+void SpriteCache::insert(const QString &path, const QSize &size, Qt::AspectRatioMode mode, bool flipX,
+                         const QPixmap &pixmap)
+{
+    Cache &c = cache();
+    const Key key{ path, size.isValid() ? size : QSize(), quint8(mode), flipX };
+    if (c.pixmaps.contains(key)) return;
+    store(c, key, pixmap);
+}
+
+QImage SpriteCache::readScaled(const QString &path, const QSize &size, Qt::AspectRatioMode mode)
+{
+    QImageReader reader(path);
+    if (size.isValid() && !size.isEmpty()) {
+        // mismo tamaño final que QPixmap::scaled(size, mode)
+        const QSize src = reader.size();
+        if (src.isValid()) {
+            const QSize target = src.scaled(size, mode);
+            if (target != src) reader.setScaledSize(target);
+        } else {
+            // el formato no dice su tamaño sin decodificar: leer y escalar
+            const QImage full = reader.read();
+            return full.isNull() ? full : full.scaled(size, mode, Qt::SmoothTransformation);
+        }
+    }
+    return reader.read();
+}
+
+SpriteCache::Stats SpriteCache::stats()
+{
+    return cache().stats;
+}
+
+void SpriteCache::clear()
+{
+    Cache &c = cache();
+    c.pixmaps.clear();
+    for (int i = 0; i < static_cast<int>(SpriteId::Count); ++i) {
+        c.byId[i] = QPixmap();
+        c.resolved[i] = false;
+    }
+    c.stats.entries = 0;
+    c.stats.bytes = 0;
+}
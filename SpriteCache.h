@@ -0,0 +1,52 @@
+#ifndef SPRITECACHE_H
+#define SPRITECACHE_H
+
+#pragma once
+#include <QImage>
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+#include "Assets.h"
+
+// Caché de sprites de todo el proceso: cada variante (ruta, tamaño, modo de
+// aspecto, espejado) se decodifica y escala una sola vez y después se reparte
+// el mismo QPixmap compartido. No se vacía al reiniciar un nivel, así que
+// reintentar no vuelve a decodificar nada. Sólo desde el hilo de la GUI.
+// Las variantes cocinadas (SpriteAtlas) salen del atlas sin escalar nada.
+class SpriteCache {
+public:
+    struct Stats {
+        int entries = 0;
+        qint64 bytes = 0;       // memoria aproximada de los pixmaps guardados
+        quint64 hits = 0;
+        quint64 misses = 0;
+
+        double hitRate() const { return hits + misses ? double(hits) / double(hits + misses) : 0.0; }
+    };
+
+    // 'size' vacío = tamaño original. Si el archivo no existe devuelve un
+    // pixmap nulo (y lo recuerda, para no volver a intentarlo).
+    static QPixmap get(const QString &path, const QSize &size = QSize(),
+                       Qt::AspectRatioMode mode = Qt::IgnoreAspectRatio, bool flipX = false);
+
+    // La variante de kSpriteDefs: después de la primera vez es un índice en
+    // un arreglo, sin armar la ruta ni buscar en el hash
+    static QPixmap get(SpriteId id);
+
+    // Para AssetPreloader: entrega una variante ya decodificada en otro hilo
+    // (no cuenta como pedido). Si ya estaba no la reemplaza.
+    static bool contains(const QString &path, const QSize &size = QSize(),
+                         Qt::AspectRatioMode mode = Qt::IgnoreAspectRatio, bool flipX = false);
+    static void insert(const QString &path, const QSize &size, Qt::AspectRatioMode mode, bool flipX,
+                       const QPixmap &pixmap);
+
+    // Decodifica 'path' directamente al tamaño final (QImageReader con
+    // setScaledSize): el archivo no pasa por un QPixmap a tamaño completo.
+    // Sólo usa QImage, así que vale desde cualquier hilo.
+    static QImage readScaled(const QString &path, const QSize &size, Qt::AspectRatioMode mode);
+
+    static Stats stats();
+    static void clear();
+};
+
+#endif // SPRITECACHE_H
@@ -1,55 +1,56 @@
 #include "TopDownEnemy.h"
 #include "TopDownPlayerItem.h"
-#include "Bullet.h"
+#include "BulletSystem.h"
+#include "SpriteCache.h"
+#include "AudioMixer.h"
 #include <QGraphicsScene>
 #include <QtMath>
 #include <QRandomGenerator>
 #include <QDebug>
-#include <QSoundEffect>
 
-TopDownEnemy::TopDownEnemy(TopDownPlayerItem* target, QGraphicsScene* scene, QGraphicsItem *parent)
-    : QObject(), QGraphicsPixmapItem(parent), target_(target), scene_(scene)
+const TopDownEnemy::Prototype &TopDownEnemy::prototype()
 {
-    // 1. CARGAR IMÁGENES ORIGINALES
-    QPixmap rawWalk(":/images/images/enemigo_camina.png");
-    QPixmap rawShoot(":/images/images/enemigo_dispara.png");
-    QPixmap rawDeath(":/images/images/enemigo_muerto_2.png");
-
-    // 2. ESCALARLAS AL TAMAÑO DESEADO (40x40)
-    // Qt::KeepAspectRatio -> Para que no se deforme (no se vea gordo o flaco)
-    // Qt::SmoothTransformation -> Para que no se vea pixelado al reducirlo
-    if (!rawWalk.isNull()) {
-        walkPixmap_ = rawWalk.scaled(60, 60, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    } else {
-        // Fallback: cuadro rojo si no hay imagen
-        walkPixmap_ = QPixmap(60, 60);
-        walkPixmap_.fill(Qt::red);
-    }
-
-    if (!rawShoot.isNull()) {
-        shootPixmap_ = rawShoot.scaled(90, 90, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    } else {
-        shootPixmap_ = walkPixmap_; // Si no hay shoot, usa walk
+    static Prototype proto;
+    static bool built = false;
+    if (built) return proto;
+    built = true;
+
+    // ESCALADAS AL TAMAÑO DESEADO (Qt::KeepAspectRatio -> no se deforma)
+    proto.walk = SpriteCache::get(SpriteId::TopDownEnemyWalk);
+    proto.shoot = SpriteCache::get(SpriteId::TopDownEnemyShoot);
+    proto.death = SpriteCache::get(SpriteId::TopDownEnemyDead);
+
+    // FALLBACKS
+    if (proto.walk.isNull()) {
+        // cuadro rojo si no hay imagen
+        proto.walk = QPixmap(60, 60);
+        proto.walk.fill(Qt::red);
     }
+    if (proto.shoot.isNull()) proto.shoot = proto.walk; // Si no hay shoot, usa walk
+    if (proto.death.isNull()) proto.death = proto.walk;
+    return proto;
+}
 
-    if (!rawDeath.isNull()) {
-        deathPixmap_ = rawDeath.scaled(90, 90, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    } else {
-        // Fallback: Si no tienes imagen, usamos la de caminar pero más oscura
-        deathPixmap_ = walkPixmap_;
-    }
+TopDownEnemy::TopDownEnemy(TopDownPlayerItem* target, QGraphicsScene* scene, QGraphicsItem *parent)
+    : QObject(), QGraphicsPixmapItem(parent), WorldEntity(Phase::Actors), target_(target), scene_(scene)
+{
+    // 1. SPRITES DEL PROTOTIPO (nada se carga por enemigo)
+    const Prototype &proto = prototype();
+    walkPixmap_ = proto.walk;
+    shootPixmap_ = proto.shoot;
+    deathPixmap_ = proto.death;
 
-    // 3. APLICAR LA IMAGEN INICIAL
+    // 2. APLICAR LA IMAGEN INICIAL
     setPixmap(walkPixmap_);
 
-    // 4. CENTRAR EL PIVOTE (Igual que antes, pero ahora usa el tamaño correcto)
+    // 3. CENTRAR EL PIVOTE (Igual que antes, pero ahora usa el tamaño correcto)
     setOffset(-pixmap().width() / 2.0, -pixmap().height() / 2.0);
 
     setTransformationMode(Qt::SmoothTransformation);
     setZValue(15);
 
-    // 2. CONFIGURAR COMPORTAMIENTO (Igual que antes)
-    if (QRandomGenerator::global()->bounded(2) == 0) {
+    // 4. CONFIGURAR COMPORTAMIENTO (Igual que antes)
+    if (GameWorld::random(RngStream::Spawn)->bounded(2) == 0) {
         behavior_ = Chaser;
         // El Chaser siempre usa el sprite de caminar porque no para
         setPixmap(walkPixmap_);
@@ -59,26 +60,49 @@ TopDownEnemy::TopDownEnemy(TopDownPlayerItem* target, QGraphicsScene* scene, QGr
         setPixmap(walkPixmap_);
     }
 
-    // 3. SONIDO Y TIMERS (Igual que antes)
-    shotSound_ = new QSoundEffect(this);
-    shotSound_->setSource(QUrl("qrc:/sound/sounds/arma_enemigo.wav"));
-    shotSound_->setVolume(0.4f);
+    // 5. RITMOS (los avanza step())
+    shootInterval_ = (1500 + GameWorld::random(RngStream::AI)->bounded(1000)) / 1000.0;
+}
+
+void TopDownEnemy::hashState(StateHash &h) const
+{
+    h.addPoint(pos());
+    h.addInt(health_);
+    h.addInt(behavior_);
+    h.addInt(isMoving_);
+    h.addReal(shootElapsed_);
+    h.addReal(burn_);
+}
+
+void TopDownEnemy::step(double dt)
+{
+    if (health_ <= 0) return;
 
-    deathSound_ = new QSoundEffect(this);
-    deathSound_->setSource(QUrl("qrc:/sound/sounds/muerte-enemigo.wav"));
-    deathSound_->setVolume(1.0f); // Volumen alto para que se escuche bien
+    updateBehavior(dt);
 
-    shootTimer_ = new QTimer(this);
-    int shootInterval = 1500 + QRandomGenerator::global()->bounded(1000);
-    connect(shootTimer_, &QTimer::timeout, this, &TopDownEnemy::shootAtPlayer);
-    shootTimer_->start(shootInterval);
+    shootElapsed_ += dt;
+    if (shootElapsed_ >= shootInterval_) {
+        shootElapsed_ -= shootInterval_;
+        shootAtPlayer();
+    }
 
     if (behavior_ == Tactical) {
-        stateTimer_ = new QTimer(this);
-        connect(stateTimer_, &QTimer::timeout, this, &TopDownEnemy::toggleState);
-        stateTimer_->start(2000);
-    } else {
-        stateTimer_ = nullptr;
+        stateElapsed_ += dt;
+        if (stateElapsed_ >= kStateInterval) {
+            stateElapsed_ -= kStateInterval;
+            toggleState();
+        }
+    }
+}
+
+void TopDownEnemy::burn(double amount)
+{
+    if (health_ <= 0) return;
+    burn_ += amount;
+    const int whole = static_cast<int>(burn_);
+    if (whole > 0) {
+        burn_ -= whole;
+        takeDamage(whole);
     }
 }
 
@@ -93,9 +117,7 @@ void TopDownEnemy::takeDamage(int damage)
         // 1. Notificar muerte
         emit enemyDied(this);
 
-        if (deathSound_) {
-            deathSound_->play();
-        }
+        AudioMixer::play(SoundId::EnemyDeath); // Volumen alto para que se escuche bien
 
         // 2. Cambiar al sprite de muerto
         setPixmap(deathPixmap_);
@@ -107,21 +129,28 @@ void TopDownEnemy::takeDamage(int damage)
         setZValue(10);
 
         // 4. Parar inteligencia
-        if (shootTimer_) shootTimer_->stop();
-        if (stateTimer_) stateTimer_->stop();
+        leaveWorld();
 
         // 5. Desactivar colisiones físicas
         setData(0, "dead");
 
         // 6. Borrar tras 3 segundos
-        QTimer::singleShot(3000, this, &TopDownEnemy::deleteLater);
+        if (GameWorld *world = GameWorld::current()) {
+            // (se saca de la escena ya, en tiempo de simulación; el delete puede esperar)
+            world->after(3.0, this, [this]() {
+                if (scene()) scene()->removeItem(this);
+                deleteLater();
+            });
+        }
 
     } else {
         // Efecto de daño (Parpadeo)
         setOpacity(0.5);
-        QTimer::singleShot(100, this, [this](){
-            if(health_ > 0) setOpacity(1.0);
-        });
+        if (GameWorld *world = GameWorld::current()) {
+            world->after(0.1, this, [this]() {
+                if (health_ > 0) setOpacity(1.0);
+            });
+        }
     }
 }
 
@@ -141,7 +170,7 @@ void TopDownEnemy::updateBehavior(double dt)
     // ACTUALIZAR ROTACIÓN (Para que siempre mire al jugador)
     updateSpriteRotation();
 
-    // --- Lógica de Movimiento (Tu código de evasión ya implementado) ---
+    // --- Movimiento: seguir el campo de flujo compartido hacia el jugador ---
     bool shouldMove = false;
     if (behavior_ == Chaser) shouldMove = true;
     else if (behavior_ == Tactical) shouldMove = isMoving_;
@@ -153,30 +182,22 @@ void TopDownEnemy::updateBehavior(double dt)
         double len = std::hypot(diff.x(), diff.y());
 
         if (len > 5.0) {
-            QPointF dir = diff / len;
-            QPointF step = dir * speed_ * dt;
-
-            setPos(myPos + step);
-
-            if (isCollidingWithCover()) {
-                setPos(myPos);
-                // ... (Tu lógica de evasión lateral que ya funciona va aquí) ...
-                // Copia el bloque de if(abs(x) > abs(y)) que te di en la respuesta anterior
-                // para mantener la IA inteligente.
-                if (std::abs(dir.x()) > std::abs(dir.y())) {
-                    setPos(myPos + QPointF(0, speed_ * dt));
-                    if (isCollidingWithCover()) {
-                        setPos(myPos);
-                        setPos(myPos + QPointF(0, -speed_ * dt));
-                        if (isCollidingWithCover()) setPos(myPos);
-                    }
-                } else {
-                    setPos(myPos + QPointF(speed_ * dt, 0));
-                    if (isCollidingWithCover()) {
-                        setPos(myPos);
-                        setPos(myPos + QPointF(-speed_ * dt, 0));
-                        if (isCollidingWithCover()) setPos(myPos);
-                    }
+            // La flecha de la celda ya rodea las paredes; en la celda del
+            // jugador (o sin mundo) se va derecho
+            QPointF dir;
+            if (GameWorld *world = GameWorld::current())
+                dir = world->flowField(targetPos, kHitRadius).direction(myPos);
+            if (dir.isNull()) dir = diff / len;
+            const QPointF step = dir * speed_ * dt;
+
+            // si el paso completo choca, deslizarse por el eje que quede libre
+            const QPointF tries[] = { myPos + step,
+                                      QPointF(myPos.x() + step.x(), myPos.y()),
+                                      QPointF(myPos.x(), myPos.y() + step.y()) };
+            for (const QPointF &next : tries) {
+                if (!isCollidingWithCover(next)) {
+                    setPos(next);
+                    break;
                 }
             }
         }
@@ -218,7 +239,9 @@ void TopDownEnemy::shootAtPlayer()
     if (behavior_ == Tactical && isMoving_) return;
 
     fireBullet();
-    QTimer::singleShot(200, this, &TopDownEnemy::fireBullet);
+    if (GameWorld *world = GameWorld::current()) {
+        world->after(0.2, this, [this]() { fireBullet(); });
+    }
 }
 
 void TopDownEnemy::fireBullet()
@@ -233,25 +256,15 @@ void TopDownEnemy::fireBullet()
     double len = std::hypot(dir.x(), dir.y());
     if (len > 0.001) {
         dir /= len;
-        BulletItem *b = new BulletItem(dir, 350.0, scene_, BulletItem::Owner::Enemy);
-        QPixmap enemyBulletPix(":/images/images/bala_enemigo.png");
-        if (!enemyBulletPix.isNull()) {
-            b->setPixmap(enemyBulletPix.scaled(16, 16, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-            b->setOffset(-8, -8);
-        }
-        b->setPos(startPos + dir * 25);
-        scene_->addItem(b);
-        if (shotSound_) shotSound_->play();
+        if (GameWorld *world = GameWorld::current())
+            world->bullets().spawn(startPos + dir * 25, dir, 350.0, BulletSystem::Owner::Enemy, BulletSystem::Visual::EnemySmall);
+        AudioMixer::play(SoundId::EnemyShot, 0.4f);
     }
 }
 
-bool TopDownEnemy::isCollidingWithCover()
+bool TopDownEnemy::isCollidingWithCover(const QPointF &p) const
 {
-    QList<QGraphicsItem*> hits = collidingItems();
-    for (QGraphicsItem* item : hits) {
-        if (item->data(0).toString() == "cover") {
-            return true;
-        }
-    }
-    return false;
+    GameWorld *world = GameWorld::current();
+    if (!world) return false;
+    return world->cover().overlaps(QRectF(p.x() - kHitRadius, p.y() - kHitRadius, 2 * kHitRadius, 2 * kHitRadius));
 }
@@ -3,38 +3,61 @@
 
 #include <QGraphicsPixmapItem> // <--- CAMBIO: Usamos PixmapItem en vez de RectItem
 #include <QObject>
-#include <QTimer>
 #include <QPixmap> // Para guardar los sprites
+#include "GameWorld.h"
+#include "Collision.h"
 
 class TopDownPlayerItem;
 class QGraphicsScene;
-class QSoundEffect;
 
 // Heredamos de QGraphicsPixmapItem para manejar imagenes
-class TopDownEnemy : public QObject, public QGraphicsPixmapItem {
+class TopDownEnemy : public QObject, public QGraphicsPixmapItem, public WorldEntity {
     Q_OBJECT
 public:
+    enum { Type = TopDownEnemyType };
+    int type() const override { return Type; }
+
+    // Lo que comparten todos los enemigos top-down: sprites ya escalados (los
+    // sonidos los tiene el AudioMixer). Se arma una sola vez por proceso.
+    struct Prototype {
+        QPixmap walk;
+        QPixmap shoot;
+        QPixmap death;
+    };
+    static const Prototype &prototype();
+    static void preload() { prototype(); }
+
     explicit TopDownEnemy(TopDownPlayerItem* target, QGraphicsScene* scene, QGraphicsItem *parent = nullptr);
 
     void takeDamage(int damage);
+    // Daño continuo (lanzallamas): se acumula y se aplica en puntos enteros
+    void burn(double amount);
     bool isAlive() { return health_ > 0; }
     void updateBehavior(double dt);
 
+    // movimiento + ritmo de disparo / cambio de estado; lo llama GameWorld
+    void step(double dt) override;
+    void hashState(StateHash &h) const override;
+    QGraphicsItem *colliderItem() override { return this; }
+
 signals:
     void enemyDied(TopDownEnemy* enemy);
 
-private slots:
+private:
     void shootAtPlayer();
     void toggleState();
     void fireBullet();
 
-private:
-    bool isCollidingWithCover(); // Helper de colisiones
+    // Caja fija contra las coberturas (no depende del sprite ni de la rotación);
+    // también es el radio con el que se arma el campo de flujo
+    static constexpr qreal kHitRadius = 20.0;
+    bool isCollidingWithCover(const QPointF &p) const; // caja en 'p' contra la rejilla de GameWorld
 
     TopDownPlayerItem* target_;
     QGraphicsScene* scene_;
 
     int health_ = 3;
+    double burn_ = 0.0;   // fracción de daño por fuego aún no aplicada
     double speed_ = 85.0;
 
     enum Behavior { Chaser, Tactical };
@@ -42,10 +65,11 @@ private:
 
     bool isMoving_ = true;
 
-    QTimer *shootTimer_;
-    QTimer *stateTimer_;
-    QSoundEffect *shotSound_;
-    QSoundEffect *deathSound_;
+    // ritmos en segundos de simulación (antes eran QTimer propios)
+    double shootInterval_ = 2.0;
+    double shootElapsed_ = 0.0;
+    double stateElapsed_ = 0.0;
+    static constexpr double kStateInterval = 2.0; // el táctico alterna mover/disparar
 
     // --- NUEVO: Sprites ---
     QPixmap walkPixmap_;  // Sprite caminando (para ambos)
@@ -4,31 +4,29 @@
 #include <QtMath>
 #include <QDebug>
 #include <QTimer>
+#include "GameWorld.h"
+#include "SpriteCache.h"
+#include "Flamethrower.h"
 
 // 1. CONSTRUCTOR: Carga de Imágenes
 TopDownPlayerItem::TopDownPlayerItem(QGraphicsItem *parent)
     : QObject(), QGraphicsPixmapItem(parent) // <--- CAMBIO: QGraphicsPixmapItem
 {
-    // 1. CARGAR SPRITES
-    QPixmap rawAlive(":/images/images/jugador_vivo.png");
-    QPixmap rawDead(":/images/images/jugador_muerto.png");
-
     int sizeAlive = 70; // Tamaño normal (vivo)
     int sizeDead = 200;  // <--- CAMBIO: Hacemos al muerto MÁS GRANDE
 
-    // 2. ESCALAR Y GUARDAR (VIVO) - Se queda en 40
-    if (!rawAlive.isNull()) {
-        alivePixmap_ = rawAlive.scaled(sizeAlive, sizeAlive, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    } else {
+    // 1. CARGAR SPRITES YA ESCALADOS (SpriteCache: no se repite al reintentar)
+    alivePixmap_ = SpriteCache::get(SpriteId::TopDownPlayer);
+    deadPixmap_ = SpriteCache::get(SpriteId::TopDownPlayerDead);
+
+    // 2. FALLBACK (VIVO)
+    if (alivePixmap_.isNull()) {
         alivePixmap_ = QPixmap(sizeAlive, sizeAlive);
         alivePixmap_.fill(QColor(60, 140, 220));
     }
 
-    // 3. ESCALAR Y GUARDAR (MUERTO) - Usamos el tamaño grande
-    if (!rawDead.isNull()) {
-        // Usamos sizeDead (70) para que se vea bien el cuerpo tirado
-        deadPixmap_ = rawDead.scaled(sizeDead, sizeDead, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    } else {
+    // 3. FALLBACK (MUERTO) - Usamos el tamaño grande
+    if (deadPixmap_.isNull()) {
         deadPixmap_ = QPixmap(sizeDead, sizeDead);
         deadPixmap_.fill(Qt::darkGray);
     }
@@ -43,6 +41,14 @@ TopDownPlayerItem::TopDownPlayerItem(QGraphicsItem *parent)
     setZValue(20); // Capa superior
 
     lives_ = 6;
+
+    // el lanzallamas sigue al jugador como hijo; apagado no se dibuja
+    flamethrower_ = new Flamethrower(this);
+}
+
+void TopDownPlayerItem::setFiring(bool on)
+{
+    if (flamethrower_) flamethrower_->setFiring(on && lives_ > 0);
 }
 
 void TopDownPlayerItem::resetLives(int lives)
@@ -86,33 +92,24 @@ void TopDownPlayerItem::updateFrame(double dt)
         }
     }
 
-    // --- Mover en X y checar colisión ---
+    // --- Mover en X y luego en Y contra la rejilla de coberturas ---
+    // (si el paso choca, ese eje no se mueve)
+    GameWorld *world = GameWorld::current();
+    const CoverGrid *cover = world ? &world->cover() : nullptr;
+    QPointF p = pos();
+
     qreal dx = mx * dt;
     if (!qFuzzyIsNull(dx)) {
-        setPos(x() + dx, y());
-
-        QList<QGraphicsItem*> hits = collidingItems();
-        for (auto* item : hits) {
-            if (item->data(0).toString() == "cover") {
-                setPos(x() - dx, y()); // Revertir X
-                break;
-            }
-        }
+        const QPointF next(p.x() + dx, p.y());
+        if (!cover || !cover->overlaps(hitboxAt(next))) p = next;
     }
 
-    // --- Mover en Y y checar colisión ---
     qreal dy = my * dt;
     if (!qFuzzyIsNull(dy)) {
-        setPos(x(), y() + dy);
-
-        QList<QGraphicsItem*> hits = collidingItems();
-        for (auto* item : hits) {
-            if (item->data(0).toString() == "cover") {
-                setPos(x(), y() - dy); // Revertir Y
-                break;
-            }
-        }
+        const QPointF next(p.x(), p.y() + dy);
+        if (!cover || !cover->overlaps(hitboxAt(next))) p = next;
     }
+    if (p != pos()) setPos(p);
 
     // --- Actualizar Facing y ROTAR Sprite ---
     if (!qFuzzyIsNull(vx_) || !qFuzzyIsNull(vy_)) {
@@ -155,7 +152,11 @@ void TopDownPlayerItem::takeDamage(int amount)
 
     // Parpadeo visual
     setOpacity(0.5);
-    QTimer::singleShot(150, this, [this]() { setOpacity(1.0); });
+    if (GameWorld *world = GameWorld::current()) {
+        world->after(0.15, this, [this]() { setOpacity(1.0); });
+    } else {
+        QTimer::singleShot(150, this, [this]() { setOpacity(1.0); });
+    }
 
     emit playerHealthChanged(lives_);
 
@@ -163,6 +164,7 @@ void TopDownPlayerItem::takeDamage(int amount)
         // --- NUEVO: Poner sprite de muerto ---
         setPixmap(deadPixmap_);
         setOffset(-deadPixmap_.width()/2.0, -deadPixmap_.height()/2.0);
+        setFiring(false);
 
         emit playerDied();
     }
@@ -175,6 +177,6 @@ QPainterPath TopDownPlayerItem::shape() const
     QPainterPath path;
     // Creamos un círculo de radio 15 (30x30 total) centrado.
     // Al ser un poco más pequeño que la imagen (40x40), evitas roces molestos.
-    path.addEllipse(-15, -15, 30, 30);
+    path.addEllipse(-kHitRadius, -kHitRadius, 2 * kHitRadius, 2 * kHitRadius);
     return path;
 }
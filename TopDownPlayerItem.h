@@ -6,11 +6,17 @@
 #include <QGraphicsPixmapItem>
 #include <QPixmap>
 #include <QPointF>
+#include "Collision.h"
+
+class Flamethrower;
 
 // Heredamos de QObject (para señales) y QGraphicsPixmapItem (para visuales)
 class TopDownPlayerItem : public QObject, public QGraphicsPixmapItem {
     Q_OBJECT
 public:
+    enum { Type = TopDownPlayerItemType };
+    int type() const override { return Type; }
+
     explicit TopDownPlayerItem(QGraphicsItem *parent = nullptr);
     ~TopDownPlayerItem() override = default;
 
@@ -31,12 +37,24 @@ public:
     void updateFrame(double dt);
     QPainterPath shape() const override;
 
+    // Caja fija (no depende del sprite ni de la rotación) con la que se
+    // choca contra las coberturas; la misma medida que shape()
+    static constexpr qreal kHitRadius = 15.0;
+    QRectF hitboxAt(const QPointF &p) const
+    {
+        return QRectF(p.x() - kHitRadius, p.y() - kHitRadius, 2 * kHitRadius, 2 * kHitRadius);
+    }
+
     // Dirección de disparo (unit vector). Por defecto mantiene la última dirección.
     QPointF facingDirection() const;
 
     // Recibir daño
     void takeDamage(int amount = 1);
 
+    // Lanzallamas (emisor persistente, hijo de este item)
+    void setFiring(bool on);
+    Flamethrower *flamethrower() const { return flamethrower_; }
+
     void setSpeed(double s) { speed_ = s; }
     double speed() const { return speed_; }
 
@@ -53,6 +71,7 @@ private:
     QPointF facing_ = QPointF(1.0, 0.0);
 
     int lives_ = 6;
+    Flamethrower *flamethrower_ = nullptr;
 
     // --- NUEVO: Variables para guardar los sprites ---
     QPixmap alivePixmap_;
@@ -18,6 +18,9 @@
 #include "creditos.h"
 
 #include "GameWindow.h"
+#include "AudioMixer.h"
+#include "AssetPreloader.h"
+#include "Assets.h"
 
 
 
@@ -84,11 +87,9 @@ Interfaz::Interfaz(QWidget *parent)
 {
     ui->setupUi(this);
 
-    menuSound = new QSoundEffect(this);
-    menuSound->setSource(QUrl("qrc:/sound/sounds/tema_menu .wav"));
-    menuSound->setVolume(1.0f); // 0.0 a 1.0
-    menuSound->setLoopCount(QSoundEffect::Infinite);
-    menuSound->play();
+    // tema del menú en streaming (en bucle); arrancar el mezclador aquí deja
+    // los efectos decodificándose mientras se muestra el menú
+    AudioMixer::playMusic(MusicTrack::Menu, 1.0f);
 
     // --- Scene (parent = this para que Qt la maneje) ---
     scene = new QGraphicsScene(this);
@@ -97,6 +98,18 @@ Interfaz::Interfaz(QWidget *parent)
 
     // --- Menu y botones centrales ---
     setupMenuAndButtons();
+
+    // --- Precarga de sprites en segundo plano (el menú sigue respondiendo) ---
+    preloader_ = new AssetPreloader(this);
+    connect(preloader_, &AssetPreloader::progress, this, [this](int done, int total) {
+        if (launchPending_ && total > 0)
+            btnJugar_->setText(tr("Cargando... %1%").arg(done * 100 / total));
+    });
+    connect(preloader_, &AssetPreloader::ready, this, [this]() {
+        btnJugar_->setText(tr("Jugar"));
+        if (launchPending_) launchGame();
+    });
+    preloader_->start();
 }
 
 Interfaz::~Interfaz()
@@ -164,6 +177,7 @@ void Interfaz::setupMenuAndButtons()
     // Crear botones
 
     QPushButton *btnJugar   = new QPushButton(tr("Jugar"), btnContainer);
+    btnJugar_ = btnJugar;
     QPushButton *btnNiveles = new QPushButton(tr("Creditos"), btnContainer);
 
     // Tamaño y politicas
@@ -209,10 +223,10 @@ void Interfaz::setupMenuAndButtons()
 
     // --- Background (tu imagen de fondo, mantenida igual) ---
     central->setStyleSheet(
-        "QWidget#centralWidget {"
-        "  border-image: url(:/images/images/Caratula.jpg) 0 0 0 0 stretch stretch;"
-        "  background-position: center 120px;"
-        "}"
+        QStringLiteral("QWidget#centralWidget {"
+                       "  border-image: url(%1) 0 0 0 0 stretch stretch;"
+                       "  background-position: center 120px;"
+                       "}").arg(QLatin1String(spriteDef(SpriteId::Cover).path))
         );
 
     // --- Hover animation y sombra (instanciar animadores con parent 'central' para manejo de memoria) ---
@@ -247,29 +261,26 @@ void Interfaz::onBtnNivelesClicked()
 
 void Interfaz::onBtnJugarClicked()
 {
-    // Si tienes menuSound (QSoundEffect* menuSound miembro), hacemos fade-out y luego abrimos el nivel.
-    if (menuSound && menuSound->isPlaying()) {
-        QPropertyAnimation *anim = new QPropertyAnimation(menuSound, "volume", this);
-        anim->setDuration(550);
-        anim->setStartValue(menuSound->volume());
-        anim->setEndValue(0.0);
-        connect(anim, &QPropertyAnimation::finished, this, [this, anim]() {
-            if (menuSound) menuSound->stop();
-            anim->deleteLater();
-
-            // abrir GameWindow (el constructor de GameWindow iniciará la música del nivel)
-            GameWindow *gw = new GameWindow(1, this);
-            gw->show();
-            this->hide();
-        });
-        anim->start(QAbstractAnimation::DeleteWhenStopped);
-    } else {
-        // fallback: abrir inmediatamente
-        if (menuSound) menuSound->stop();
-        GameWindow *gw = new GameWindow(1, this);
-        gw->show();
-        this->hide();
+    // si la precarga no terminó, el nivel se abre en cuanto termine (el
+    // botón muestra el progreso) en vez de decodificar aquí bloqueando
+    if (!preloader_->isReady()) {
+        launchPending_ = true;
+        btnJugar_->setText(tr("Cargando... %1%").arg(preloader_->total() > 0
+                                                      ? preloader_->done() * 100 / preloader_->total() : 0));
+        return;
     }
+    launchGame();
+}
+
+void Interfaz::launchGame()
+{
+    launchPending_ = false;
+
+    // abrir GameWindow ya: su constructor inicia la música del nivel, que
+    // entra en fundido cruzado con el tema del menú (no hace falta esperar)
+    GameWindow *gw = new GameWindow(1, this);
+    gw->show();
+    this->hide();
 }
 
 
@@ -3,7 +3,6 @@
 
 #include <QMainWindow>
 #include <QGraphicsScene>
-#include <QSoundEffect>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -11,6 +10,9 @@ class Interfaz;
 }
 QT_END_NAMESPACE
 
+class AssetPreloader;
+class QPushButton;
+
 class Interfaz : public QMainWindow
 {
     Q_OBJECT
@@ -29,7 +31,11 @@ private:
     Ui::Interfaz *ui;
     QGraphicsScene *scene;
 
-    QSoundEffect *menuSound;
+    // sprites de los niveles decodificándose mientras se ve el menú
+    AssetPreloader *preloader_ = nullptr;
+    QPushButton *btnJugar_ = nullptr;
+    bool launchPending_ = false;   // se pulsó Jugar antes de terminar la precarga
+    void launchGame();
 
     void setupScene();
     void setupMenuAndButtons();
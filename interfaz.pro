@@ -4,18 +4,86 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
 
+# Integración de balas con AVX2 (por defecto SSE2, que todo x86-64 tiene):
+#   qmake CONFIG+=bullets_avx2
+bullets_avx2 {
+    msvc: QMAKE_CXXFLAGS += /arch:AVX2
+    else: QMAKE_CXXFLAGS += -mavx2
+}
+
+# Banco de efectos (sounds/efectos.bank, en resources.qrc): lo arma la
+# herramienta tools/soundbank a partir de los WAV. Con CONFIG+=soundbank se
+# regenera al compilar si cambió algún WAV (SOUNDBANK_TOOL: el ejecutable):
+#   qmake CONFIG+=soundbank SOUNDBANK_TOOL=/ruta/a/soundbank
+soundbank {
+    isEmpty(SOUNDBANK_TOOL): SOUNDBANK_TOOL = soundbank
+    SFX_CLIPS = arma_player=arma_player.wav arma_enemigo=arma_enemigo.wav granada=granada.wav \
+                muerte_enemigo=muerte-enemigo.wav lanzallamas=lanzallamas.wav
+    sfxbank.target = $$PWD/sounds/efectos.bank
+    sfxbank.depends = $$PWD/sounds/arma_player.wav $$PWD/sounds/arma_enemigo.wav $$PWD/sounds/granada.wav \
+                      $$PWD/sounds/muerte-enemigo.wav $$PWD/sounds/lanzallamas.wav
+    sfxbank.commands = cd $$shell_path($$PWD/sounds) && $$SOUNDBANK_TOOL -o efectos.bank $$SFX_CLIPS
+    QMAKE_EXTRA_TARGETS += sfxbank
+    PRE_TARGETDEPS += $$PWD/sounds/efectos.bank
+}
+
+# Assets (AssetList.h): cada archivo de la lista tiene que existir. Se mira
+# acá, al correr qmake, para que uno que falta no compile en vez de salir
+# como un sprite vacío en plena partida.
+ASSET_LINES = $$cat($$PWD/AssetList.h, lines)
+for(line, ASSET_LINES) {
+    !contains(line, "^(SPRITE|IMAGE|MUSIC)\\(.*"): next()
+    asset = $$replace(line, "^[A-Z]+\\([^\"]*\"([^\"]+)\".*$", "\\1")
+    !exists($$PWD/$$asset): error("Falta el asset $$asset (AssetList.h)")
+}
+
+# Sprites cocinados: con CONFIG+=cooked_sprites la herramienta tools/assetcook
+# escala y espeja cada SPRITE de AssetList.h y las empaqueta en atlas
+# (cooked/, con su índice y su .qrc), que reemplazan a los PNG originales de
+# sprites.qrc. Sin cocinar, SpriteCache escala los originales al cargar.
+#   qmake CONFIG+=cooked_sprites ASSETCOOK_TOOL=/ruta/a/assetcook
+cooked_sprites {
+    isEmpty(ASSETCOOK_TOOL): ASSETCOOK_TOOL = assetcook
+    spriteatlas.target = $$PWD/cooked/sprites.qrc
+    spriteatlas.depends = $$PWD/AssetList.h $$files($$PWD/images/*.png)
+    spriteatlas.commands = $$ASSETCOOK_TOOL -o $$shell_path($$PWD/cooked) $$shell_path($$PWD/AssetList.h)
+    QMAKE_EXTRA_TARGETS += spriteatlas
+    # rcc necesita el .qrc ya al correr qmake: la primera vez se cocina acá
+    !exists($$PWD/cooked/sprites.qrc) {
+        !system($$spriteatlas.commands): error("assetcook falló: revisa AssetList.h")
+    }
+    PRE_TARGETDEPS += $$PWD/cooked/sprites.qrc
+    RESOURCES += cooked/sprites.qrc
+} else {
+    RESOURCES += sprites.qrc
+}
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
-    Bullet.cpp \
+    AssetPreloader.cpp \
+    AudioMixer.cpp \
+    BroadphaseOverlay.cpp \
+    BulletSystem.cpp \
     BunkerBossItem.cpp \
+    CharacterController.cpp \
+    CoverGrid.cpp \
     EnemyItem.cpp \
-    FlameArea.cpp \
+    Flamethrower.cpp \
+    FlowField.cpp \
     GameWindow.cpp \
+    GameWorld.cpp \
+    MusicStream.cpp \
     PlayerItem.cpp \
     Projectile.cpp \
+    Replay.cpp \
+    SoundBank.cpp \
+    SpatialHash.cpp \
+    SpriteAtlas.cpp \
+    SpriteBatchItem.cpp \
+    SpriteCache.cpp \
     TopDownEnemy.cpp \
     TopDownPlayerItem.cpp \
     main.cpp \
@@ -23,13 +91,33 @@ SOURCES += \
     niveles.cpp
 
 HEADERS += \
-    Bullet.h \
+    AssetList.h \
+    AssetPreloader.h \
+    Assets.h \
+    AudioMixer.h \
+    BroadphaseOverlay.h \
+    BulletSystem.h \
     BunkerBossItem.h \
+    CharacterController.h \
+    Collision.h \
+    CoverGrid.h \
+    CoverItem.h \
     EnemyItem.h \
-    FlameArea.h \
+    Flamethrower.h \
+    FlowField.h \
     GameWindow.h \
+    GameWorld.h \
+    MusicStream.h \
+    ObjectPool.h \
     PlayerItem.h \
     Projectile.h \
+    Replay.h \
+    SoundBank.h \
+    SoundBankFormat.h \
+    SpatialHash.h \
+    SpriteAtlas.h \
+    SpriteBatchItem.h \
+    SpriteCache.h \
     TopDownEnemy.h \
     TopDownPlayerItem.h \
     interfaz.h \
@@ -1,9 +1,77 @@
 #include "interfaz.h"
+#include "GameWindow.h"
+#include "Replay.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+#include <QDebug>
+#include <cstring>
 
 int main(int argc, char *argv[])
 {
+    // --headless: simula un nivel sin ventana ni audio, tan rápido como dé la CPU.
+    // Hay que elegir la plataforma "offscreen" ANTES de crear QApplication.
+    bool headless = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) headless = true;
+    }
+    if (headless && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("headless"),
+                      QStringLiteral("Simula el juego sin ventana ni audio, a máxima velocidad.")});
+    parser.addOption({QStringLiteral("level"),
+                      QStringLiteral("Nivel a simular en modo headless (1 o 2)."),
+                      QStringLiteral("n"), QStringLiteral("1")});
+    parser.addOption({QStringLiteral("seconds"),
+                      QStringLiteral("Segundos de juego a simular en modo headless."),
+                      QStringLiteral("s"), QStringLiteral("60")});
+    parser.addOption({QStringLiteral("seed"),
+                      QStringLiteral("Semilla de la partida (0 = al azar)."),
+                      QStringLiteral("n"), QStringLiteral("0")});
+    parser.addOption({QStringLiteral("record"),
+                      QStringLiteral("Graba la partida (entrada por tick + semilla) en este archivo."),
+                      QStringLiteral("archivo")});
+    parser.addOption({QStringLiteral("replay"),
+                      QStringLiteral("Reproduce una partida grabada con --record y verifica cada tick."),
+                      QStringLiteral("archivo")});
+    parser.process(a);
+
+    // --replay fija nivel y semilla (los de la grabación)
+    Replay replay;
+    const bool replaying = parser.isSet(QStringLiteral("replay"));
+    if (replaying) {
+        QString error;
+        if (!replay.load(parser.value(QStringLiteral("replay")), &error)) {
+            qCritical().noquote() << "no se pudo leer la repetición:" << error;
+            return 1;
+        }
+    }
+    const int level = replaying ? replay.level() : parser.value(QStringLiteral("level")).toInt();
+    const quint64 seed = replaying ? replay.seed() : parser.value(QStringLiteral("seed")).toULongLong();
+
+    // Grabar o reproducir abre el nivel directamente (sin pasar por el menú)
+    if (headless || replaying || parser.isSet(QStringLiteral("record"))) {
+        if (headless) {
+            // los qDebug por bala/enemigo dominarían el tiempo; dejamos sólo qInfo y avisos
+            QLoggingCategory::setFilterRules(QStringLiteral("default.debug=false"));
+        }
+
+        GameWindow game(level, nullptr, headless, seed);
+        if (replaying) game.startReplay(replay);
+        else if (parser.isSet(QStringLiteral("record"))) game.startRecording(parser.value(QStringLiteral("record")));
+
+        if (headless) return game.runHeadless(parser.value(QStringLiteral("seconds")).toDouble());
+
+        game.show();
+        return a.exec();
+    }
+
     Interfaz w;
     w.show();
     return a.exec();
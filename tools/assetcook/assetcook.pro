@@ -0,0 +1,12 @@
+# Herramienta de build: cocina los sprites de AssetList.h en atlas ya
+# escalados y espejados, con su índice y el .qrc que los embebe.
+#   assetcook -o cooked AssetList.h
+# Se usa desde interfaz.pro con CONFIG+=cooked_sprites.
+TEMPLATE = app
+TARGET = assetcook
+QT = core gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+SOURCES += \
+    main.cpp
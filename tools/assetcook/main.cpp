@@ -0,0 +1,284 @@
+// assetcook: cocina los sprites de AssetList.h en atlas.
+//
+//   assetcook [--page N] -o dir AssetList.h
+//
+// Cada línea SPRITE (archivo, tamaño, modo, espejado) se escala y espeja una
+// vez acá, con el filtro bueno, y se empaqueta en páginas PNG. Lo que
+// quedaría más grande que el original (los fondos) no se cocina: sólo
+// agrandaría el recurso. Deja en 'dir':
+//   spritesN.png   las páginas
+//   sprites.idx    dónde quedó cada variante (lo lee SpriteAtlas)
+//   sprites.qrc    los dos anteriores bajo el prefijo /cooked
+// Así el juego ya no escala nada al cargar y sólo embebe lo que dibuja.
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QPainter>
+#include <QRect>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+const int kDefaultPage = 2048;
+const char *const kPrefix = ":/images/";   // el de las rutas de kSpriteDefs (Assets.h)
+const int kPadding = 1;          // entre sprites, por si se dibujan con filtrado
+
+struct Sprite {
+    QString file;                // relativo a la lista
+    QSize size;                  // inválido = original
+    Qt::AspectRatioMode mode = Qt::IgnoreAspectRatio;
+    bool flipX = false;
+    QImage image;
+    int page = -1;
+    QPoint pos;
+};
+
+struct Page {
+    int width = 0;
+    int height = 0;
+    int shelfY = 0;              // repisa actual
+    int shelfH = 0;
+    int cursorX = 0;
+};
+
+int fail(const QString &msg)
+{
+    std::fprintf(stderr, "assetcook: %s\n", qPrintable(msg));
+    return 1;
+}
+
+void usage()
+{
+    std::fprintf(stderr, "uso: assetcook [--page N] -o dir AssetList.h\n");
+}
+
+bool readAssetList(const QString &path, QVector<Sprite> &out, QString &error)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        error = path + QStringLiteral(": ") + f.errorString();
+        return false;
+    }
+
+    // SPRITE(id, "archivo", ancho, alto, Modo, espejado); lo demás se ignora
+    static const QRegularExpression sprite(QStringLiteral(
+        "^\\s*SPRITE\\(\\s*\\w+\\s*,\\s*\"([^\"]+)\"\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,"
+        "\\s*(Ignore|Keep)\\s*,\\s*(true|false)\\s*\\)"));
+    QTextStream in(&f);
+    int lineNo = 0;
+    while (!in.atEnd()) {
+        ++lineNo;
+        const QString line = in.readLine();
+        if (!line.trimmed().startsWith(QLatin1String("SPRITE("))) continue;
+        const QRegularExpressionMatch m = sprite.match(line);
+        if (!m.hasMatch()) {
+            error = QStringLiteral("%1:%2: SPRITE mal formado").arg(path).arg(lineNo);
+            return false;
+        }
+
+        Sprite s;
+        s.file = m.captured(1);
+        const int w = m.captured(2).toInt();
+        const int h = m.captured(3).toInt();
+        s.size = w > 0 ? QSize(w, h) : QSize();
+        s.mode = m.captured(4) == QLatin1String("Keep") ? Qt::KeepAspectRatio : Qt::IgnoreAspectRatio;
+        s.flipX = m.captured(5) == QLatin1String("true");
+        out.append(s);
+    }
+    return true;
+}
+
+// Igual que SpriteCache (QPixmap::scaled + espejado después de escalar),
+// pero el escalado se hace premultiplicado para que los bordes no se
+// ensucien con el color de los píxeles transparentes
+QImage cook(const QImage &src, const Sprite &s)
+{
+    QImage img = src.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    if (s.size.isValid()) {
+        const QSize target = img.size().scaled(s.size, s.mode);
+        if (target != img.size()) img = img.scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+    if (s.flipX) img = img.mirrored(true, false);
+    return img;
+}
+
+// Repisas: de más alto a más bajo, de izquierda a derecha; cuando no entra
+// ni en una repisa nueva, página nueva. Lo que no cabe en una página va solo.
+void pack(QVector<Sprite> &sprites, int pageSize, QVector<Page> &pages)
+{
+    QVector<Sprite*> order;
+    for (Sprite &s : sprites) order.append(&s);
+    std::stable_sort(order.begin(), order.end(), [](const Sprite *a, const Sprite *b) {
+        return a->image.height() != b->image.height() ? a->image.height() > b->image.height()
+                                                       : a->image.width() > b->image.width();
+    });
+
+    for (Sprite *s : order) {
+        const int w = s->image.width() + kPadding;
+        const int h = s->image.height() + kPadding;
+        if (w > pageSize || h > pageSize) {
+            Page p;
+            p.width = s->image.width();
+            p.height = s->image.height();
+            s->page = pages.size();
+            s->pos = QPoint(0, 0);
+            pages.append(p);
+            continue;
+        }
+
+        bool placed = false;
+        for (int i = 0; i < pages.size() && !placed; ++i) {
+            Page &p = pages[i];
+            if (p.width != pageSize) continue;          // página de un solo sprite
+            if (p.cursorX + w > pageSize) {             // repisa nueva
+                if (p.shelfY + p.shelfH + h > pageSize) continue;
+                p.shelfY += p.shelfH;
+                p.shelfH = 0;
+                p.cursorX = 0;
+            }
+            if (p.shelfY + h > pageSize) continue;
+            s->page = i;
+            s->pos = QPoint(p.cursorX, p.shelfY);
+            p.cursorX += w;
+            p.shelfH = qMax(p.shelfH, h);
+            p.height = qMax(p.height, p.shelfY + p.shelfH);
+            placed = true;
+        }
+        if (!placed) {
+            Page p;
+            p.width = pageSize;
+            p.cursorX = w;
+            p.shelfH = h;
+            p.height = h;
+            s->page = pages.size();
+            s->pos = QPoint(0, 0);
+            pages.append(p);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QString outDir, list;
+    int pageSize = kDefaultPage;
+    const QStringList args = app.arguments();
+    for (int i = 1; i < args.size(); ++i) {
+        if (args[i] == QLatin1String("-o") && i + 1 < args.size()) outDir = args[++i];
+        else if (args[i] == QLatin1String("--page") && i + 1 < args.size()) pageSize = args[++i].toInt();
+        else if (list.isEmpty()) list = args[i];
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (outDir.isEmpty() || list.isEmpty() || pageSize <= 0) {
+        usage();
+        return 2;
+    }
+
+    QString error;
+    QVector<Sprite> listed;
+    if (!readAssetList(list, listed, error)) return fail(error);
+    if (listed.isEmpty()) return fail(list + QStringLiteral(": no hay sprites"));
+
+    // cada archivo se decodifica una vez para todas sus variantes
+    const QDir base = QFileInfo(list).absoluteDir();
+    QVector<Sprite> sprites;
+    int skipped = 0;
+    qint64 inBytes = 0;
+    QString lastFile;
+    QImage source;
+    std::stable_sort(listed.begin(), listed.end(), [](const Sprite &a, const Sprite &b) { return a.file < b.file; });
+    for (Sprite &s : listed) {
+        if (s.file != lastFile) {
+            const QString path = base.filePath(s.file);
+            QImageReader reader(path);
+            source = reader.read();
+            if (source.isNull()) return fail(path + QStringLiteral(": ") + reader.errorString());
+            inBytes += QFileInfo(path).size();
+            lastFile = s.file;
+        }
+        if (s.size.isValid()) {
+            const QSize target = source.size().scaled(s.size, s.mode);
+            if (qint64(target.width()) * target.height() > qint64(source.width()) * source.height()) {
+                ++skipped;
+                continue;
+            }
+        }
+        s.image = cook(source, s);
+        sprites.append(s);
+    }
+
+    QVector<Page> pages;
+    pack(sprites, pageSize, pages);
+
+    if (!QDir().mkpath(outDir)) return fail(outDir + QStringLiteral(": no se pudo crear"));
+    const QDir out(outDir);
+
+    qint64 outBytes = 0;
+    QStringList files;
+    for (int i = 0; i < pages.size(); ++i) {
+        QImage page(pages[i].width, pages[i].height, QImage::Format_ARGB32_Premultiplied);
+        page.fill(Qt::transparent);
+        QPainter painter(&page);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        for (const Sprite &s : sprites)
+            if (s.page == i) painter.drawImage(s.pos, s.image);
+        painter.end();
+
+        const QString name = QStringLiteral("sprites%1.png").arg(i);
+        QImageWriter writer(out.filePath(name), "png");
+        writer.setQuality(0);   // PNG: compresión máxima
+        if (!writer.write(page.convertToFormat(QImage::Format_ARGB32)))
+            return fail(name + QStringLiteral(": ") + writer.errorString());
+        outBytes += QFileInfo(out.filePath(name)).size();
+        files.append(name);
+    }
+
+    // índice: una línea por página y una por variante, la ruta al final
+    QFile idx(out.filePath(QStringLiteral("sprites.idx")));
+    if (!idx.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return fail(idx.fileName() + QStringLiteral(": ") + idx.errorString());
+    QTextStream ts(&idx);
+    ts << "# generado por assetcook a partir de " << QFileInfo(list).fileName() << ": no editar\n";
+    ts << "assetcook 1\n";
+    for (int i = 0; i < pages.size(); ++i)
+        ts << "page " << i << ' ' << files[i] << '\n';
+    for (const Sprite &s : sprites) {
+        ts << "sprite " << s.page << ' ' << s.pos.x() << ' ' << s.pos.y() << ' '
+           << s.image.width() << ' ' << s.image.height() << ' '
+           << (s.size.isValid() ? s.size.width() : -1) << ' ' << (s.size.isValid() ? s.size.height() : -1) << ' '
+           << (s.mode == Qt::KeepAspectRatio ? "keep" : "ignore") << ' ' << (s.flipX ? 1 : 0) << ' '
+           << kPrefix << s.file << '\n';
+    }
+    idx.close();
+
+    // los PNG ya vienen comprimidos: sin comprimir otra vez en el .qrc
+    QFile qrc(out.filePath(QStringLiteral("sprites.qrc")));
+    if (!qrc.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return fail(qrc.fileName() + QStringLiteral(": ") + qrc.errorString());
+    QTextStream qs(&qrc);
+    qs << "<!-- generado por assetcook a partir de " << QFileInfo(list).fileName() << ": no editar -->\n";
+    qs << "<RCC>\n    <qresource prefix=\"/cooked\">\n";
+    for (const QString &f : files)
+        qs << "        <file compression-algorithm=\"none\">" << f << "</file>\n";
+    qs << "        <file>sprites.idx</file>\n";
+    qs << "    </qresource>\n</RCC>\n";
+    qrc.close();
+
+    std::printf("assetcook: %d variantes en %d páginas (%d sin cocinar), %lld KB -> %lld KB\n",
+                int(sprites.size()), int(pages.size()), skipped, inBytes / 1024, outBytes / 1024);
+    return 0;
+}
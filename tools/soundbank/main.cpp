@@ -0,0 +1,257 @@
+// soundbank: empaqueta los WAV de efectos en un banco (ver SoundBankFormat.h).
+//
+//   soundbank [--pcm] [--rate N] -o salida.bank nombre=archivo.wav ...
+//
+// Cada clip se pasa a mono y a la frecuencia del banco (sinc con ventana, así
+// bajar de 48 kHz no deja aliasing) y, salvo --pcm, se comprime a IMA-ADPCM.
+// Sin Qt a propósito: se compila con cualquier compilador C++17.
+#include "../../SoundBankFormat.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace soundbank;
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+struct Clip {
+    std::string name;
+    std::string path;
+    std::vector<float> mono;     // a la frecuencia del banco
+    std::vector<uint8_t> data;
+    uint8_t codec = Pcm16;
+    uint32_t frames = 0;
+};
+
+uint16_t rd16(const uint8_t *p) { return uint16_t(p[0] | (p[1] << 8)); }
+uint32_t rd32(const uint8_t *p) { return uint32_t(p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24)); }
+
+bool readWav(const std::string &path, std::vector<float> &mono, int &rate, std::string &error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) { error = "no se puede abrir"; return false; }
+    const std::vector<uint8_t> b((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (b.size() < 12 || std::memcmp(b.data(), "RIFF", 4) != 0 || std::memcmp(b.data() + 8, "WAVE", 4) != 0) {
+        error = "no es RIFF/WAVE";
+        return false;
+    }
+
+    int format = 0, channels = 0, bits = 0;
+    const uint8_t *data = nullptr;
+    size_t dataSize = 0;
+    rate = 0;
+    for (size_t off = 12; off + 8 <= b.size(); ) {
+        const uint32_t size = rd32(&b[off + 4]);
+        const size_t body = off + 8;
+        const size_t avail = std::min<size_t>(size, b.size() - body);
+        if (std::memcmp(&b[off], "fmt ", 4) == 0 && avail >= 16) {
+            format = rd16(&b[body]);
+            channels = rd16(&b[body + 2]);
+            rate = int(rd32(&b[body + 4]));
+            bits = rd16(&b[body + 14]);
+        } else if (std::memcmp(&b[off], "data", 4) == 0) {
+            data = &b[body];
+            dataSize = avail;
+        }
+        off = body + size + (size & 1);
+    }
+    if (format != 1 || !data || channels < 1 || rate <= 0 || (bits != 8 && bits != 16)) {
+        error = "sólo PCM de 8/16 bits";
+        return false;
+    }
+
+    const int bytes = bits / 8;
+    const size_t frames = dataSize / (size_t(channels) * bytes);
+    mono.resize(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        float sum = 0.0f;
+        for (int ch = 0; ch < channels; ++ch) {
+            const uint8_t *s = data + (i * channels + ch) * bytes;
+            sum += bits == 8 ? float((int(*s) - 128) * 256) : float(int16_t(rd16(s)));
+        }
+        mono[i] = sum / channels;
+    }
+    return true;
+}
+
+// Sinc con ventana de Blackman; al bajar de frecuencia el corte baja con ella
+std::vector<float> resample(const std::vector<float> &in, int from, int to)
+{
+    if (from == to || in.empty()) return in;
+
+    const double ratio = double(to) / from;
+    const double cutoff = std::min(1.0, ratio) * 0.95;
+    const int halfTaps = 24;
+    const double support = halfTaps / cutoff;     // en muestras de entrada
+
+    const size_t outFrames = size_t(std::floor(in.size() * ratio));
+    std::vector<float> out(outFrames);
+    for (size_t i = 0; i < outFrames; ++i) {
+        const double center = i / ratio;
+        const long first = long(std::ceil(center - support));
+        const long last = long(std::floor(center + support));
+        double acc = 0.0, norm = 0.0;
+        for (long k = first; k <= last; ++k) {
+            const double x = (k - center) * cutoff;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(kPi * x) / (kPi * x);
+            const double t = (k - center) / support;   // -1..1
+            const double w = 0.42 + 0.5 * std::cos(kPi * t) + 0.08 * std::cos(2.0 * kPi * t);
+            const double h = sinc * w;
+            norm += h;
+            if (k >= 0 && size_t(k) < in.size()) acc += in[size_t(k)] * h;
+        }
+        out[i] = float(norm != 0.0 ? acc / norm : 0.0);
+    }
+    return out;
+}
+
+int16_t toS16(float v)
+{
+    const long r = std::lround(v);
+    return int16_t(r > 32767 ? 32767 : (r < -32768 ? -32768 : r));
+}
+
+void encodePcm(Clip &c)
+{
+    c.codec = Pcm16;
+    c.data.resize(c.mono.size() * 2);
+    for (size_t i = 0; i < c.mono.size(); ++i) {
+        const uint16_t v = uint16_t(toS16(c.mono[i]));
+        c.data[i * 2] = uint8_t(v & 0xFF);
+        c.data[i * 2 + 1] = uint8_t(v >> 8);
+    }
+}
+
+void encodeAdpcm(Clip &c)
+{
+    c.codec = ImaAdpcm;
+    const size_t n = c.mono.size();
+    const size_t blocks = (n + kAdpcmBlockSamples - 1) / kAdpcmBlockSamples;
+    c.data.assign(blocks * kAdpcmBlockBytes, 0);
+
+    AdpcmState st;
+    for (size_t blk = 0; blk < blocks; ++blk) {
+        uint8_t *out = &c.data[blk * kAdpcmBlockBytes];
+        const size_t base = blk * kAdpcmBlockSamples;
+
+        // cabecera: la primera muestra va entera y el índice sigue del bloque anterior
+        st.predictor = toS16(c.mono[base]);
+        out[0] = uint8_t(uint16_t(st.predictor) & 0xFF);
+        out[1] = uint8_t(uint16_t(st.predictor) >> 8);
+        out[2] = uint8_t(st.index);
+        out[3] = 0;
+
+        for (int k = 0; k < kAdpcmBlockSamples - 1; ++k) {
+            const size_t i = base + 1 + k;
+            const int nibble = i < n ? encodeSample(st, toS16(c.mono[i])) : 0;
+            out[4 + k / 2] |= uint8_t((k & 1) ? nibble << 4 : nibble);
+        }
+    }
+
+    // el último bloque sólo ocupa lo que tiene
+    const size_t tail = n - (blocks - 1) * kAdpcmBlockSamples;
+    c.data.resize((blocks - 1) * kAdpcmBlockBytes + 4 + tail / 2);
+}
+
+void usage()
+{
+    std::fprintf(stderr, "uso: soundbank [--pcm] [--rate N] -o salida.bank nombre=archivo.wav ...\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string outPath;
+    bool pcm = false;
+    int rate = int(kDefaultRate);
+    std::vector<Clip> clips;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--pcm") pcm = true;
+        else if (a == "--rate" && i + 1 < argc) rate = std::atoi(argv[++i]);
+        else if (a == "-o" && i + 1 < argc) outPath = argv[++i];
+        else {
+            const size_t eq = a.find('=');
+            if (eq == std::string::npos || eq == 0 || eq >= sizeof(BankEntry::name)) {
+                usage();
+                return 2;
+            }
+            Clip c;
+            c.name = a.substr(0, eq);
+            c.path = a.substr(eq + 1);
+            clips.push_back(c);
+        }
+    }
+    if (outPath.empty() || clips.empty() || rate <= 0 || clips.size() > 0xFFFF) {
+        usage();
+        return 2;
+    }
+
+    size_t inBytes = 0;
+    for (Clip &c : clips) {
+        std::vector<float> mono;
+        int srcRate = 0;
+        std::string error;
+        if (!readWav(c.path, mono, srcRate, error)) {
+            std::fprintf(stderr, "%s: %s\n", c.path.c_str(), error.c_str());
+            return 1;
+        }
+        inBytes += std::ifstream(c.path, std::ios::binary | std::ios::ate).tellg();
+        c.mono = resample(mono, srcRate, rate);
+        c.frames = uint32_t(c.mono.size());
+        if (pcm || c.mono.empty()) encodePcm(c);
+        else encodeAdpcm(c);
+    }
+
+    // cabecera, tabla y datos alineados a 4
+    BankHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.count = uint16_t(clips.size());
+    header.sampleRate = uint32_t(rate);
+
+    std::vector<BankEntry> entries(clips.size());
+    uint32_t offset = uint32_t(sizeof(BankHeader) + entries.size() * sizeof(BankEntry));
+    for (size_t i = 0; i < clips.size(); ++i) {
+        BankEntry &e = entries[i];
+        std::memset(&e, 0, sizeof(e));
+        std::memcpy(e.name, clips[i].name.data(), clips[i].name.size());
+        e.codec = clips[i].codec;
+        e.frames = clips[i].frames;
+        e.offset = offset;
+        e.size = uint32_t(clips[i].data.size());
+        offset += (e.size + 3) & ~3u;
+    }
+
+    std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::fprintf(stderr, "%s: no se puede escribir\n", outPath.c_str());
+        return 1;
+    }
+    // el banco se lee mapeado en máquinas little endian (x86, ARM)
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), std::streamsize(entries.size() * sizeof(BankEntry)));
+    for (const Clip &c : clips) {
+        out.write(reinterpret_cast<const char*>(c.data.data()), std::streamsize(c.data.size()));
+        static const char pad[3] = { 0, 0, 0 };
+        out.write(pad, std::streamsize((4 - c.data.size() % 4) % 4));
+    }
+    if (!out) {
+        std::fprintf(stderr, "%s: error de escritura\n", outPath.c_str());
+        return 1;
+    }
+
+    std::printf("%s: %zu clips, %u Hz mono, %s, %u bytes (WAV de entrada: %zu bytes)\n",
+                outPath.c_str(), clips.size(), unsigned(rate), pcm ? "PCM 16" : "IMA-ADPCM",
+                unsigned(offset), inBytes);
+    return 0;
+}
@@ -0,0 +1,14 @@
+# Herramienta de build: empaqueta los WAV de efectos en sounds/efectos.bank
+# (formato en SoundBankFormat.h). No usa Qt.
+#   soundbank -o efectos.bank arma_player=arma_player.wav ...
+# La lista de clips está en interfaz.pro (CONFIG+=soundbank).
+TEMPLATE = app
+TARGET = soundbank
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    ../../SoundBankFormat.h